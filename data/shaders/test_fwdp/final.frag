@@ -129,7 +129,6 @@ layout (location = 0) in VertexData {
     float view_depth;
 };
 
-layout (set = 0, binding = 2) uniform sampler2D[] textures;
 
 layout (set = 1, binding = 0) buffer readonly PointLights {
     PointLight[] point_lights;
@@ -149,6 +148,8 @@ layout (set = 1, binding = 4) uniform Cascades {
 
 layout (set = 1, binding = 5) uniform sampler2DArray shadow;
 
+layout (set = 2, binding = 0) uniform sampler2D[] textures;
+
 layout (push_constant) uniform Indices {
     uint model_index;
     uint diffuse_index;
@@ -2,7 +2,7 @@
 #extension GL_EXT_nonuniform_qualifier: enable
 #extension GL_ARB_separate_shader_objects: enable
 
-layout (set = 0, binding = 2) uniform sampler2D[] textures;
+layout (set = 1, binding = 0) uniform sampler2D[] textures;
 
 layout (location = 0) in vec2 uvs;
 
@@ -34,4 +34,6 @@ namespace crd {
     };
 
     template <typename T> crd_nodiscard crd_module Async<T> make_async(std::future<T>&&) noexcept;
+    // Wraps an object which is already available.
+    template <typename T> crd_nodiscard crd_module Async<T> make_async(T&&) noexcept;
 } // namespace crd
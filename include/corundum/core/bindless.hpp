@@ -0,0 +1,63 @@
+#pragma once
+
+#include <corundum/core/constants.hpp>
+
+#include <corundum/detail/forward.hpp>
+#include <corundum/detail/macros.hpp>
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <vector>
+#include <array>
+#include <mutex>
+
+namespace crd {
+    // Slot 0 is never handed out, shaders treat it as "no texture".
+    constexpr auto bindless_null_slot = 0u;
+
+    // One renderer-wide table holding every resident texture at a stable slot, bound once instead of rebuilding
+    // texture arrays every frame. The table keeps one descriptor set per frame in flight. A slot fresh from allocate()
+    // is written to every copy right away, no pending frame can use it yet. A live slot (a streamed texture changing
+    // view) is never written in place: the write is queued and reaches each copy in begin_frame, once the previous
+    // submission of that frame completed. Released slots are only reused `in_flight` frames later.
+    // Pipelines name the set they bind it to in their CreateInfo::bindless_set to share this layout.
+    struct BindlessTable {
+        struct Retired {
+            std::uint32_t slot;
+            std::uint64_t frame;
+        };
+        struct Write {
+            std::uint32_t slot;
+            VkDescriptorImageInfo info;
+        };
+        VkDevice device;
+        VkDescriptorPool pool;
+        VkDescriptorSetLayout layout;
+        std::array<VkDescriptorSet, in_flight> sets;
+        // Writes to live slots each copy still has to apply.
+        std::array<std::vector<Write>, in_flight> queued;
+        std::vector<std::uint32_t> available;
+        std::vector<Retired> retired;
+        std::uint32_t next;
+        std::uint32_t capacity;
+        // Copy of the frame being recorded.
+        std::uint32_t current;
+        std::uint64_t frame;
+        std::mutex lock;
+
+        // Reserves a slot and writes it to every copy.
+        crd_nodiscard crd_module std::uint32_t   allocate(VkDescriptorImageInfo) noexcept;
+        // Queues a new descriptor for a live slot.
+                      crd_module void            update(std::uint32_t, VkDescriptorImageInfo) noexcept;
+        // Drops the writes still queued for the slot, whatever they reference may be destroyed once this returns.
+                      crd_module void            release(std::uint32_t) noexcept;
+        // Makes the copy of frame `index` current and applies the writes queued for it, then recycles the slots
+        // released at least `in_flight` frames ago. The previous submission of that frame must have completed.
+                      crd_module void            begin_frame(std::uint32_t) noexcept;
+        crd_nodiscard crd_module VkDescriptorSet current_set() const noexcept;
+    };
+
+    crd_nodiscard crd_module BindlessTable* make_bindless_table(const Context&, std::uint32_t = bindless_capacity) noexcept;
+                  crd_module void           destroy_bindless_table(BindlessTable*&) noexcept;
+} // namespace crd
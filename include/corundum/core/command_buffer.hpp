@@ -47,6 +47,21 @@ namespace crd {
         std::uint32_t dest_mip;
     };
 
+    struct BufferCopy {
+        const StaticBuffer* source;
+        const StaticBuffer* dest;
+        std::size_t source_offset;
+        std::size_t dest_offset;
+        std::size_t size;
+    };
+
+    struct BufferImageCopy {
+        const StaticBuffer* source;
+        const Image* dest;
+        std::size_t source_offset;
+        std::uint32_t mip;
+    };
+
     struct CommandBuffer {
         struct CreateInfo {
             std::uint32_t count;
@@ -56,6 +71,9 @@ namespace crd {
         const Framebuffer* active_framebuffer;
         const RenderPass* active_pass;
         const Pipeline* active_pipeline;
+        VkBuffer bound_vertices;
+        VkBuffer bound_indices;
+        VkIndexType bound_index_type;
         VkCommandBuffer handle;
         VkCommandPool pool;
 
@@ -70,14 +88,16 @@ namespace crd {
         crd_module CommandBuffer& set_depth_bias(float, float) noexcept;
         crd_module CommandBuffer& bind_pipeline(const Pipeline&) noexcept;
         crd_module CommandBuffer& bind_descriptor_set(std::uint32_t, const DescriptorSet<1>&) noexcept;
+        crd_module CommandBuffer& bind_descriptor_set(std::uint32_t, const BindlessTable&) noexcept;
         crd_module CommandBuffer& bind_vertex_buffer(const StaticBuffer&) noexcept;
-        crd_module CommandBuffer& bind_index_buffer(const StaticBuffer&) noexcept;
+        crd_module CommandBuffer& bind_index_buffer(const StaticBuffer&, VkIndexType = VK_INDEX_TYPE_UINT32) noexcept;
         crd_module CommandBuffer& bind_static_mesh(const StaticMesh&) noexcept;
         crd_module CommandBuffer& push_constants(VkShaderStageFlags, const void*, std::size_t) noexcept;
         crd_module CommandBuffer& clear_image(const Image&, const ClearValue&) noexcept;
         crd_module CommandBuffer& dispatch(std::uint32_t = 1, std::uint32_t = 1, std::uint32_t = 1) noexcept;
         crd_module CommandBuffer& draw(std::uint32_t, std::uint32_t, std::uint32_t, std::uint32_t) noexcept;
         crd_module CommandBuffer& draw_indexed(std::uint32_t, std::uint32_t, std::uint32_t, std::int32_t, std::uint32_t) noexcept;
+        crd_module CommandBuffer& draw_static_mesh(const StaticMesh&, std::uint32_t = 1, std::uint32_t = 0) noexcept;
         crd_module CommandBuffer& trace_rays(std::uint32_t, std::uint32_t) noexcept;
         crd_module CommandBuffer& end_render_pass() noexcept;
         crd_module CommandBuffer& build_acceleration_structure(const VkAccelerationStructureBuildGeometryInfoKHR*,
@@ -85,7 +105,9 @@ namespace crd {
         crd_module CommandBuffer& copy_image(const Image&, const Image&) noexcept;
         crd_module CommandBuffer& blit_image(const ImageBlit&) noexcept;
         crd_module CommandBuffer& copy_buffer(const StaticBuffer&, const StaticBuffer&) noexcept;
+        crd_module CommandBuffer& copy_buffer(const BufferCopy&) noexcept;
         crd_module CommandBuffer& copy_buffer_to_image(const StaticBuffer&, const Image&) noexcept;
+        crd_module CommandBuffer& copy_buffer_to_image(const BufferImageCopy&) noexcept;
         crd_module CommandBuffer& barrier(const BufferMemoryBarrier&) noexcept;
         crd_module CommandBuffer& barrier(const ImageMemoryBarrier&) noexcept;
         crd_module CommandBuffer& barrier(VkPipelineStageFlags, VkPipelineStageFlags) noexcept;
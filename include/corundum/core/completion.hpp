@@ -0,0 +1,35 @@
+#pragma once
+
+#include <corundum/detail/forward.hpp>
+#include <corundum/detail/macros.hpp>
+
+#include <vulkan/vulkan.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include <mutex>
+
+namespace crd {
+    // Owns a single thread which polls the device for completed work on behalf of suspended fibers,
+    // so that worker threads are never blocked inside vkWaitSemaphores.
+    struct CompletionService {
+        struct Watch {
+            VkSemaphore timeline;
+            std::uint64_t ticket;
+            ftl::WaitGroup* waiter;
+        };
+        VkDevice device;
+        std::thread poller;
+        std::condition_variable wake;
+        std::vector<Watch> pending;
+        std::mutex lock;
+        bool running;
+
+        crd_module void watch(VkSemaphore, std::uint64_t, ftl::WaitGroup*) noexcept;
+    };
+
+    crd_nodiscard crd_module CompletionService* make_completion_service(const Context&) noexcept;
+                  crd_module void               destroy_completion_service(CompletionService*&) noexcept;
+} // namespace crd
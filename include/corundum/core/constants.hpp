@@ -5,10 +5,21 @@
 namespace crd {
     constexpr struct inverted_viewport_tag_t {} inverted_viewport;
 
-    constexpr auto dynamic_size      = 128u;
-    constexpr auto in_flight         = 2u;
-    constexpr auto vertex_components = 14; // 3 + 3 + 2 + 3 + 3
-    constexpr auto vertex_size       = sizeof(float[vertex_components]);
-    constexpr auto external_subpass  = VK_SUBPASS_EXTERNAL;
-    constexpr auto family_ignored    = VK_QUEUE_FAMILY_IGNORED;
+    constexpr auto dynamic_size        = 128u;
+    constexpr auto in_flight           = 2u;
+    constexpr auto vertex_components   = 14; // 3 + 3 + 2 + 3 + 3
+    constexpr auto vertex_size         = sizeof(float[vertex_components]);
+    constexpr auto compact_vertex_size = 24ull; // 12 + 4 + 4 + 4
+    constexpr auto external_subpass    = VK_SUBPASS_EXTERNAL;
+    constexpr auto family_ignored      = VK_QUEUE_FAMILY_IGNORED;
+    constexpr auto staging_size        = 64ull * 1024 * 1024;
+    constexpr auto staging_alignment   = 16ull;
+    constexpr auto geometry_block_size = 64ull * 1024 * 1024;
+    constexpr auto streaming_budget    = 16ull * 1024 * 1024;
+    constexpr auto streaming_tail_size = 128u;
+    constexpr auto io_queue_depth      = 64u;
+    constexpr auto io_chunk_size       = 1024ull * 1024;
+    constexpr auto io_alignment        = 4096ull;
+    constexpr auto bindless_capacity   = 16384u;
+    constexpr auto transient_pool_sets = 1024u;
 } // namespace crd
@@ -30,12 +30,21 @@ namespace crd {
         struct {
             bool descriptor_indexing;
             bool buffer_address;
+            bool memory_budget;
             bool raytracing;
         } extensions;
         QueueFamilies families;
         VkDevice device;
         VmaAllocator allocator;
+        StagingRing* staging;
+        UploadBatcher* uploads;
+        FileReader* reader;
+        dtl::Archive* archive;
+        GeometryArena* geometry;
+        TextureStreamer* streamer;
         ftl::TaskScheduler* scheduler;
+        CompletionService* completion;
+        DescriptorBatcher* descriptors;
         VkDescriptorPool descriptor_pool;
         Queue* graphics;
         Queue* transfer;
@@ -45,4 +54,7 @@ namespace crd {
     crd_nodiscard crd_module Context       make_context() noexcept;
                   crd_module void          destroy_context(Context&) noexcept;
     crd_nodiscard crd_module std::uint32_t max_bound_samplers(const Context&) noexcept;
+    // Maps a .crdp archive standing in for the `root` directory, every asset path under it then resolves through
+    // the archive. Mount before requesting assets. False (and nothing mounted) when the archive is missing or invalid.
+    crd_nodiscard crd_module bool          mount_archive(Context&, const char*, const char*) noexcept;
 } // namespace crd
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <corundum/core/constants.hpp>
+
+#include <corundum/detail/forward.hpp>
+#include <corundum/detail/macros.hpp>
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <array>
+#include <mutex>
+
+namespace crd {
+    // Hands out descriptor sets which only live for one frame. Every frame in flight owns a chain of pools created
+    // without FREE_DESCRIPTOR_SET_BIT: sets are carved linearly from the current pool, the chain grows by one pool
+    // when it runs out, and the whole chain is reset with vkResetDescriptorPool once the frame comes around again
+    // and its previous submission completed. Sets which outlive a frame keep coming from Context::descriptor_pool.
+    struct DescriptorAllocator {
+        struct Chain {
+            std::vector<VkDescriptorPool> pools;
+            std::size_t current;
+            // Whether any set was allocated since the last reset.
+            bool used;
+        };
+        const Context* context;
+        VkDevice device;
+        DescriptorBatcher* batcher;
+        std::array<Chain, in_flight> frames;
+        std::uint32_t frame;
+        std::mutex lock;
+
+        crd_nodiscard crd_module VkDescriptorSet allocate(const DescriptorSetLayout&) noexcept;
+        // Makes frame `index` current, resetting its chain. When any set was allocated from it, first waits for
+        // `ticket`, the previous submission of that frame on the graphics queue.
+                      crd_module void            begin_frame(std::uint32_t, std::uint64_t) noexcept;
+    };
+
+    crd_nodiscard crd_module DescriptorAllocator* make_descriptor_allocator(const Context&) noexcept;
+                  crd_module void                 destroy_descriptor_allocator(DescriptorAllocator*&) noexcept;
+} // namespace crd
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <corundum/detail/forward.hpp>
+#include <corundum/detail/macros.hpp>
+
+#include <vulkan/vulkan.h>
+
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+
+namespace crd {
+    // Collects descriptor writes instead of issuing one vkUpdateDescriptorSets per bind. Every thread records into
+    // its own arena, the payload of a write is copied there so callers may reuse their arrays right away. flush()
+    // submits every recorded write in a single call. It runs when a descriptor set is first bound to a command
+    // buffer and before a set is freed, since a set may not be updated once bound (without update-after-bind).
+    struct DescriptorBatcher {
+        struct Arena {
+            struct Pending {
+                VkWriteDescriptorSet write;
+                // Index of the first descriptor in the payload of the write's kind.
+                std::size_t first;
+            };
+            std::vector<Pending> writes;
+            std::vector<VkDescriptorBufferInfo> buffers;
+            std::vector<VkDescriptorImageInfo> images;
+#if defined(crd_enable_raytracing)
+            std::vector<VkAccelerationStructureKHR> structures;
+#endif
+            std::mutex lock;
+        };
+        VkDevice device;
+        // Unique for the lifetime of the process, keys the thread local arena cache.
+        std::uint64_t id;
+        std::unordered_map<std::thread::id, Arena*> arenas;
+        // Scratch of flush(), kept to reuse its capacity.
+        std::vector<VkWriteDescriptorSet> writes;
+#if defined(crd_enable_raytracing)
+        std::vector<VkWriteDescriptorSetAccelerationStructureKHR> structure_writes;
+#endif
+        std::atomic<std::uint32_t> pending;
+        std::mutex lock;
+
+        crd_module void write(VkDescriptorSet, const DescriptorBinding&, std::uint32_t, const VkDescriptorBufferInfo*, std::uint32_t) noexcept;
+        crd_module void write(VkDescriptorSet, const DescriptorBinding&, std::uint32_t, const VkDescriptorImageInfo*, std::uint32_t) noexcept;
+#if defined(crd_enable_raytracing)
+        crd_module void write(VkDescriptorSet, const DescriptorBinding&, std::uint32_t, const VkAccelerationStructureKHR*, std::uint32_t) noexcept;
+#endif
+        // Cheap when nothing was recorded since the last flush.
+        crd_module void flush() noexcept;
+    };
+
+    crd_nodiscard crd_module DescriptorBatcher* make_descriptor_batcher(const Context&) noexcept;
+                  crd_module void               destroy_descriptor_batcher(DescriptorBatcher*&) noexcept;
+} // namespace crd
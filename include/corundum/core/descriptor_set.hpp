@@ -7,19 +7,33 @@
 
 #include <vulkan/vulkan.h>
 
+#include <cstdint>
+#include <cstddef>
 #include <vector>
 #include <array>
 
 namespace crd {
     template <>
     struct DescriptorSet<1> {
-        struct Hashed {
-            std::size_t binding;
-            std::size_t descriptor;
+        // Last descriptors written to a binding, element by element. Only the contiguous ranges which differ
+        // from it are written again, elements never written hold null handles.
+        struct Shadow {
+            std::vector<VkDescriptorBufferInfo> buffers;
+            std::vector<VkDescriptorImageInfo> images;
+#if defined(crd_enable_raytracing)
+            std::vector<VkAccelerationStructureKHR> structures;
+#endif
         };
         const Context* context;
         VkDescriptorSet handle;
-        std::vector<Hashed> bound;
+        // Null for transient sets, which are recycled with their frame rather than freed.
+        VkDescriptorPool pool;
+        // Taken from the layout the set was allocated with.
+        VkDescriptorUpdateTemplate update_template;
+        std::uint32_t template_size;
+        std::uint64_t templated;
+        // Indexed by binding.
+        std::vector<Shadow> bound;
 
         crd_module DescriptorSet<1>& bind(const DescriptorBinding&, VkDescriptorBufferInfo) noexcept;
         crd_module DescriptorSet<1>& bind(const DescriptorBinding&, VkDescriptorImageInfo) noexcept;
@@ -35,6 +49,15 @@ namespace crd {
 #endif
         crd_module DescriptorSet<1>& bind(const DescriptorBinding&, std::uint32_t, const std::vector<VkDescriptorImageInfo>&) noexcept;
 
+        // Writes every sized binding at once through the layout's update template. The struct packs their descriptors
+        // in binding order with no padding: one VkDescriptorBufferInfo, VkDescriptorImageInfo or VkAccelerationStructureKHR
+        // per array element. Unsized arrays are not part of it and still go through bind().
+        crd_module DescriptorSet<1>& update(const void*, std::size_t) noexcept;
+        template <typename T>
+        DescriptorSet<1>& update(const T& descriptors) noexcept {
+            return update(&descriptors, sizeof(T));
+        }
+
         crd_module void              destroy() noexcept;
     };
 
@@ -56,6 +79,12 @@ namespace crd {
 #endif
                       crd_module DescriptorSet<in_flight>& bind(const DescriptorBinding&, std::uint32_t, const std::vector<VkDescriptorImageInfo>&) noexcept;
 
+                      crd_module DescriptorSet<in_flight>& update(const void*, std::size_t) noexcept;
+        template <typename T>
+                      DescriptorSet<in_flight>&            update(const T& descriptors) noexcept {
+            return update(&descriptors, sizeof(T));
+        }
+
         crd_nodiscard crd_module DescriptorSet<1>&         operator [](std::size_t) noexcept;
         crd_nodiscard crd_module const DescriptorSet<1>&   operator [](std::size_t) const noexcept;
 
@@ -63,4 +92,6 @@ namespace crd {
     };
 
     template <std::size_t N = in_flight> crd_nodiscard crd_module DescriptorSet<N> make_descriptor_set(const Context&, DescriptorSetLayout) noexcept;
+    // Allocated from the pools of the current frame, valid until that frame is acquired again. Destroying it is optional.
+                                         crd_nodiscard crd_module DescriptorSet<1> make_transient_descriptor_set(Renderer&, DescriptorSetLayout) noexcept;
 } // namespace crd
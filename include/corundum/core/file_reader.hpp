@@ -0,0 +1,83 @@
+#pragma once
+
+#include <corundum/core/constants.hpp>
+
+#include <corundum/detail/file_view.hpp>
+#include <corundum/detail/forward.hpp>
+#include <corundum/detail/io_ring.hpp>
+#include <corundum/detail/macros.hpp>
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <thread>
+#include <deque>
+#include <mutex>
+
+namespace crd {
+    enum FileAccess {
+        file_access_random,
+        // Hints the kernel to read ahead aggressively, for formats consumed front to back.
+        file_access_sequential
+    };
+
+    struct AsyncFile {
+#if defined(_WIN32)
+        void* handle;
+#else
+        int handle;
+#endif
+        std::size_t size;
+        // Set when the path resolved to the mounted archive, reads are then plain copies out of it.
+        dtl::FileView view;
+    };
+
+    struct ReadBuffer {
+        std::uint8_t* data;
+        std::size_t capacity;
+    };
+
+    struct ReadRequest {
+        const AsyncFile* file;
+        std::uint8_t* dest;
+        std::size_t size;
+        std::size_t offset;
+        // Bytes landed so far, short reads are resubmitted for the remainder.
+        std::size_t done;
+        ftl::WaitGroup* waiter;
+        bool failed;
+    };
+
+    // Reads files without stalling scheduler threads on page faults. On Linux requests go through io_uring with at
+    // most `depth` reads in flight, the rest wait in the backlog. Elsewhere, or when the kernel refuses io_uring,
+    // a dedicated thread serves them with positional reads. Either way completions resume the waiting fiber.
+    struct FileReader {
+        dtl::IoRing ring;
+        bool uring;
+        std::thread completer;
+        // Only used by the positional read fallback.
+        std::condition_variable wake;
+        std::deque<ReadRequest*> backlog;
+        // Released buffers, aligned to io_alignment.
+        std::vector<ReadBuffer> pool;
+        std::uint32_t in_flight;
+        std::uint32_t depth;
+        std::mutex lock;
+        bool running;
+
+                      crd_module void       enqueue(ReadRequest*) noexcept;
+        crd_nodiscard crd_module ReadBuffer acquire(std::size_t) noexcept;
+                      crd_module void       release(ReadBuffer&) noexcept;
+    };
+
+    crd_nodiscard crd_module FileReader* make_file_reader(std::uint32_t = io_queue_depth) noexcept;
+                  crd_module void        destroy_file_reader(FileReader*&) noexcept;
+
+    crd_nodiscard crd_module AsyncFile   open_file(const char*, FileAccess = file_access_random) noexcept;
+                  crd_module void        close_file(AsyncFile&) noexcept;
+    // Reads `size` bytes at `offset` into any destination, a pooled buffer or mapped staging memory alike.
+    // Large reads are split in io_chunk_size requests kept in flight together. Suspends the calling fiber until done.
+    // False when the range lies past the end of the file or any request failed, the destination is then undefined.
+    crd_nodiscard crd_module bool        read_file(const Context&, const AsyncFile&, void*, std::size_t, std::size_t = 0) noexcept;
+} // namespace crd
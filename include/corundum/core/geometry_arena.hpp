@@ -0,0 +1,74 @@
+#pragma once
+
+#include <corundum/core/static_buffer.hpp>
+
+#include <corundum/detail/forward.hpp>
+#include <corundum/detail/macros.hpp>
+
+#include <vulkan/vulkan.h>
+
+#include <unordered_map>
+#include <unordered_set>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <mutex>
+
+namespace crd {
+    struct GeometryBlock {
+        struct Free {
+            std::size_t offset;
+            std::size_t size;
+        };
+        GeometryHeap* heap;
+        StaticBuffer buffer;
+        // Sorted by offset, adjacent ranges are always coalesced.
+        std::vector<Free> free;
+    };
+
+    // Stable allocation record, defragmentation moves the data and patches the record in place.
+    struct GeometryRange {
+        GeometryBlock* block;
+        std::size_t offset;
+        std::size_t size;
+        // Size of one element (vertex or index), offsets are always a multiple of it.
+        std::uint32_t stride;
+    };
+
+    struct GeometryHeap {
+        VkBufferUsageFlags usage;
+        std::size_t block_size;
+        std::vector<GeometryBlock*> blocks;
+        std::unordered_set<GeometryRange*> ranges;
+    };
+
+    // Suballocates vertex and index data of every StaticMesh from a handful of large device buffers.
+    struct GeometryArena {
+        struct Retired {
+            GeometryBlock* block;
+            // Graphics queue ticket after which no submission reads the block anymore.
+            std::uint64_t ticket;
+        };
+        GeometryHeap vertices;
+        GeometryHeap indices;
+        // Ranges a running defragmentation is copying, and where they land once it is done.
+        std::unordered_map<GeometryRange*, GeometryRange> moving;
+        std::vector<Retired> retired;
+        bool defragmenting;
+        std::mutex lock;
+
+        crd_nodiscard crd_module GeometryRange* allocate_vertices(const Context&, std::size_t, std::uint32_t) noexcept;
+        crd_nodiscard crd_module GeometryRange* allocate_indices(const Context&, std::size_t, std::uint32_t) noexcept;
+                      crd_module void           free(GeometryRange*) noexcept;
+        // Repacks every live range into as few blocks as possible, suspending the calling fiber while the copies run.
+        // The arena stays usable meanwhile, ranges keep pointing at their old data until the copies completed.
+        // Must not race with recording command buffers or with uploads into existing ranges, their offsets
+        // and device addresses change. The old blocks are retired until the graphics queue is past them.
+                      crd_module void           defragment(const Context&) noexcept;
+        // Destroys the retired blocks the graphics queue is done with.
+                      crd_module void           collect(const Context&) noexcept;
+    };
+
+    crd_nodiscard crd_module GeometryArena* make_geometry_arena(const Context&) noexcept;
+                  crd_module void           destroy_geometry_arena(const Context&, GeometryArena*&) noexcept;
+} // namespace crd
@@ -13,10 +13,16 @@
 
 namespace crd {
     enum VertexAttribute {
-        vertex_attribute_vec1 = sizeof(float[1]),
-        vertex_attribute_vec2 = sizeof(float[2]),
-        vertex_attribute_vec3 = sizeof(float[3]),
-        vertex_attribute_vec4 = sizeof(float[4])
+        vertex_attribute_vec1,
+        vertex_attribute_vec2,
+        vertex_attribute_vec3,
+        vertex_attribute_vec4,
+        // Two half floats, e.g. texture coordinates.
+        vertex_attribute_half2,
+        // Two signed normalized shorts, e.g. an octahedral-encoded normal.
+        vertex_attribute_snorm16x2,
+        // Four signed normalized bytes, e.g. an octahedral-encoded tangent and its bitangent sign.
+        vertex_attribute_snorm8x4
     };
 
     enum ColorAttachment {
@@ -32,10 +38,22 @@ namespace crd {
         VkShaderStageFlags stage;
     };
 
+    // The reflected layout of this set is replaced by the renderer's bindless table layout only when a pipeline
+    // names it in `bindless_set`, the set must then hold nothing but an unsized sampler array at binding 0.
+    constexpr auto no_bindless_set = ~0u;
+
     struct DescriptorSetLayout {
         VkDescriptorSetLayout handle;
         std::uint32_t dyn_binds;
         bool dynamic;
+        // Writes every binding of the set but its unsized arrays in one call, null when there are none.
+        VkDescriptorUpdateTemplate update_template;
+        // Size of the struct the template reads from, see DescriptorSet<1>::update.
+        std::uint32_t template_size;
+        // Bit i is set when the template writes binding i.
+        std::uint64_t templated;
+        // The renderer's bindless table layout, bound through BindlessTable and never allocated from.
+        bool bindless;
     };
 
     using DescriptorSetLayouts = std::vector<DescriptorSetLayout>;
@@ -84,12 +102,15 @@ namespace crd {
                 bool test;
                 bool write;
             } depth;
+            // Set bound to the renderer's bindless table, see BindlessTable.
+            std::uint32_t bindless_set = no_bindless_set;
         };
     };
 
     struct ComputePipeline : Pipeline {
         struct CreateInfo {
             const char* compute;
+            std::uint32_t bindless_set = no_bindless_set;
             // TODO:
         };
     };
@@ -100,6 +121,7 @@ namespace crd {
             const char* raymiss;
             const char* raychit;
             std::vector<VkDynamicState> states;
+            std::uint32_t bindless_set = no_bindless_set;
         };
         ShaderBindingTable sbt;
     };
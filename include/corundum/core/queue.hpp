@@ -5,6 +5,7 @@
 
 #include <vulkan/vulkan.h>
 
+#include <cstdint>
 #include <vector>
 #include <mutex>
 
@@ -26,30 +27,41 @@ namespace crd {
         QueueFamily compute;
     };
 
+    struct QueueWait {
+        const Queue* queue;
+        std::uint64_t ticket;
+        VkPipelineStageFlags stage;
+    };
+
     struct SubmitInfo {
         const CommandBuffer& commands;
         std::vector<VkPipelineStageFlags> stages;
         std::vector<VkSemaphore> waits;
         std::vector<VkSemaphore> signals;
-        VkFence done;
+        std::vector<QueueWait> tickets;
     };
 
     struct Queue {
         VkQueue handle;
         VkCommandPool pool;
         std::vector<VkCommandPool> transient;
+        // Signaled with the submission's ticket once it completes.
+        VkSemaphore timeline;
+        std::uint64_t ticket;
         std::uint32_t family;
         std::mutex lock;
 
-        crd_module void     submit(const SubmitInfo&) noexcept;
-        crd_module VkResult present(const Swapchain&, std::uint32_t, std::vector<VkSemaphore>&&) noexcept;
-        crd_module void     wait_idle() noexcept;
+        crd_module std::uint64_t submit(const SubmitInfo&) noexcept;
+        crd_module VkResult      present(const Swapchain&, std::uint32_t, std::vector<VkSemaphore>&&) noexcept;
+        crd_module void          wait_idle() noexcept;
     };
 
     crd_nodiscard crd_module Queue* make_queue(const Context&, QueueFamily) noexcept;
                   crd_module void   destroy_queue(const Context&, Queue*&) noexcept;
 
-                  crd_module void   wait_fence(const Context&, VkFence) noexcept;
+    crd_nodiscard crd_module bool   is_complete(const Context&, const Queue&, std::uint64_t) noexcept;
+                  crd_module void   wait_ticket(const Context&, const Queue&, std::uint64_t) noexcept;
+                  crd_module void   await_ticket(const Context&, const Queue&, std::uint64_t) noexcept;
                   crd_module void   immediate_submit(const Context&, const CommandBuffer&, QueueType) noexcept;
 
 } // namespace crd
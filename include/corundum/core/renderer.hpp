@@ -23,7 +23,7 @@ namespace crd {
         std::uint32_t index;
         VkSemaphore wait;
         VkSemaphore signal;
-        VkFence done;
+        std::uint64_t done;
     };
 
     struct PresentInfo {
@@ -50,11 +50,18 @@ namespace crd {
         std::vector<CommandBuffer> gfx_cmds;
         in_flight_array<VkSemaphore> img_ready;
         in_flight_array<VkSemaphore> gfx_done;
-        in_flight_array<VkFence> cmd_wait;
+        in_flight_array<std::uint64_t> frame_ticket;
 
         // TODO: Move to another structure (Cache<T>)
         std::unordered_map<std::size_t, VkDescriptorSetLayout> set_layout_cache;
+        // Keyed like set_layout_cache.
+        std::unordered_map<std::size_t, VkDescriptorUpdateTemplate> set_template_cache;
         std::unordered_map<std::size_t, VkSampler> sampler_cache;
+        TextureRegistry* textures;
+        // Null without descriptor indexing, textures then have no slot.
+        BindlessTable* bindless;
+        // Transient descriptor sets, one pool chain per frame in flight.
+        DescriptorAllocator* descriptors;
 
         crd_nodiscard crd_module FrameInfo acquire_frame(Window&, Swapchain&) noexcept;
                       crd_module void      present_frame(PresentInfo&&) noexcept;
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <corundum/core/static_buffer.hpp>
+#include <corundum/core/constants.hpp>
+
+#include <corundum/detail/forward.hpp>
+#include <corundum/detail/macros.hpp>
+
+#include <cstdint>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+namespace crd {
+    struct StagingBlock {
+        StaticBuffer* buffer;
+        std::size_t offset;
+        std::size_t size;
+        std::uint64_t end;
+        void* mapped;
+        bool dedicated;
+    };
+
+    // Persistently mapped upload ring shared by every asset request. Blocks are handed out in order
+    // and may be released in any order once the GPU is done reading them, the tail only moves past
+    // a block when every block before it was released too. Requests which do not fit fall back to
+    // a dedicated buffer rather than waiting on the ring.
+    struct StagingRing {
+        struct Retire {
+            std::uint64_t end;
+            bool released;
+        };
+        StaticBuffer buffer;
+        std::uint64_t head;
+        std::uint64_t tail;
+        std::deque<Retire> in_flight;
+        std::mutex lock;
+
+        crd_nodiscard crd_module StagingBlock allocate(const Context&, std::size_t, std::size_t = staging_alignment) noexcept;
+                      crd_module void         release(const StagingBlock&) noexcept;
+    };
+
+    crd_nodiscard crd_module StagingRing* make_staging_ring(const Context&, std::size_t = staging_size) noexcept;
+                  crd_module void         destroy_staging_ring(const Context&, StagingRing*&) noexcept;
+} // namespace crd
@@ -14,6 +14,8 @@ namespace crd {
             VkBufferUsageFlags flags;
             VmaMemoryUsage usage;
             std::size_t capacity;
+            // Accessible from every queue family without ownership transfers.
+            bool shared;
         };
         const Context* context;
         VmaAllocation allocation;
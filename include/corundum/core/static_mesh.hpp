@@ -1,30 +1,90 @@
 #pragma once
 
 #include <corundum/core/acceleration_structure.hpp>
-#include <corundum/core/static_buffer.hpp>
+#include <corundum/core/geometry_arena.hpp>
+#include <corundum/core/staging_ring.hpp>
+#include <corundum/core/constants.hpp>
 
 #include <corundum/detail/forward.hpp>
 #include <corundum/detail/macros.hpp>
 
+#include <vulkan/vulkan.h>
+
 #include <optional>
 #include <cstdint>
+#include <cstddef>
 #include <vector>
 #include <future>
+#include <span>
 
 namespace crd {
+    enum VertexFormat {
+        // vec3 position, vec3 normal, vec2 uv, vec3 tangent, vec3 bitangent.
+        vertex_format_float,
+        // vec3 position, snorm16x2 octahedral normal, half2 uv,
+        // snorm8x4 octahedral tangent with the bitangent sign in z.
+        vertex_format_compact
+    };
+
+    crd_nodiscard crd_module constexpr std::size_t vertex_stride(VertexFormat format) noexcept {
+        return format == vertex_format_compact ? compact_vertex_size : vertex_size;
+    }
+
+    // Every index of a mesh with at most 65536 vertices fits in 16 bits, primitive restart is never enabled.
+    // Ray tracing shaders fetch the indices through the buffer address as 32 bit triplets, so they stay wide there.
+    crd_nodiscard crd_module constexpr VkIndexType narrowed_index_type(std::uint32_t vertex_count) noexcept {
+#if defined(crd_enable_raytracing)
+        static_cast<void>(vertex_count);
+        return VK_INDEX_TYPE_UINT32;
+#else
+        return vertex_count <= 65536 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+#endif
+    }
+
     struct StaticMesh {
         struct CreateInfo {
-            std::vector<float> geometry;
+            // Tightly packed vertices in the given format.
+            std::vector<std::uint8_t> geometry;
             std::vector<std::uint32_t> indices;
+            VertexFormat format;
         };
         const Context* context;
-        StaticBuffer geometry;
-        StaticBuffer indices;
+        VertexFormat format;
+        GeometryRange* geometry;
+        GeometryRange* indices;
+        std::uint32_t vertex_count;
+        std::uint32_t index_count;
+        // See narrowed_index_type.
+        VkIndexType index_type;
 #if defined(crd_enable_raytracing)
         BottomLevelAS blas;
 #endif
         crd_module void destroy() noexcept;
     };
 
+    // Staging memory reserved for a mesh: vertices and indices are written in place, then the mesh is committed
+    // without any intermediate copy. The reservation holds back the staging ring, commit it soon.
+    struct MeshBuilder {
+        const Context* context;
+        StagingBlock staging;
+        VertexFormat format;
+        std::uint32_t vertex_count;
+        std::uint32_t index_count;
+        VkIndexType index_type;
+        // Tightly packed vertices in the given format.
+        std::span<std::uint8_t> vertices;
+        // Directly follow the vertices in staging, only the span matching index_type is set.
+        std::span<std::uint16_t> indices16;
+        std::span<std::uint32_t> indices32;
+
+        // Writes the indices starting at `first`, narrowing them when index_type is 16 bits.
+        crd_module void write_indices(std::span<const std::uint32_t>, std::size_t = 0) noexcept;
+    };
+
     crd_nodiscard crd_module Async<StaticMesh> request_static_mesh(const Context&, StaticMesh::CreateInfo&&) noexcept;
+    // Indices are 16 bits whenever narrowed_index_type allows it.
+    crd_nodiscard crd_module MeshBuilder       reserve_static_mesh(const Context&, VertexFormat, std::uint32_t, std::uint32_t) noexcept;
+    crd_nodiscard crd_module Async<StaticMesh> commit_static_mesh(MeshBuilder&&) noexcept;
+    // Commits on the calling fiber, which is suspended until the upload completed.
+    crd_nodiscard crd_module StaticMesh        make_static_mesh(MeshBuilder&&) noexcept;
 } // namespace crd
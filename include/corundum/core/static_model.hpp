@@ -10,6 +10,9 @@
 
 #include <vulkan/vulkan.h>
 
+#include <glm/mat4x4.hpp>
+
+#include <cstdint>
 #include <vector>
 #include <string>
 
@@ -24,11 +27,24 @@ namespace crd {
     };
 
     struct StaticModel {
+        // One placement of a submesh by a node of the source scene.
+        struct Instance {
+            std::uint32_t submesh;
+            // Node to model space, with every parent node applied.
+            glm::mat4 transform;
+        };
         const Context* context;
+        Renderer* renderer;
+        // Every mesh of the source once, however many nodes reference it.
         std::vector<TexturedMesh> submeshes;
+        // In node walk order, the instances of one submesh can share a single instanced draw_indexed.
+        std::vector<Instance> instances;
 
         crd_module void destroy() noexcept;
     };
 
-    crd_nodiscard crd_module Async<StaticModel> request_static_model(Renderer&, std::string&&) noexcept;
+    // Loads the cooked .crdm next to the model when there is one, otherwise imports the model itself with Assimp.
+    crd_nodiscard crd_module Async<StaticModel>        request_static_model(Renderer&, std::string&&, VertexFormat = vertex_format_float) noexcept;
+    // Imports a model and serializes it as a .crdm container (see detail/model_format.hpp), empty on failure.
+    crd_nodiscard crd_module std::vector<std::uint8_t> cook_static_model(const std::string&, VertexFormat = vertex_format_float) noexcept;
 } // namespace crd
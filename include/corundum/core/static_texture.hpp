@@ -15,12 +15,32 @@ namespace crd {
         texture_unorm = VK_FORMAT_R8G8B8A8_UNORM
     };
 
+    enum TextureLoad {
+        // The request completes once every level is resident.
+        texture_load_full,
+        // The request completes once the levels up to streaming_tail_size are resident, the rest are streamed in afterwards.
+        texture_load_streamed
+    };
+
     struct StaticTexture {
+        // Left empty for streamed textures, their allocation is owned by the residency and may be replaced.
         Image image;
         VkSampler sampler;
+        // Only set for streamed textures, info() then samples from the most detailed resident level.
+        TextureResidency* residency;
+        // Stable index of the texture in the renderer's bindless table, bindless_null_slot without one.
+        // Safe to store in material data for as long as the texture lives, see bindless_slot().
+        BindlessTable* bindless;
+        std::uint32_t slot;
 
         crd_nodiscard crd_module VkDescriptorImageInfo info() const noexcept;
+        // The slot, marking the texture used this frame. Material data caching the slot must call mark_used() every
+        // frame the texture is sampled instead, the streamer only tracks use through info(), bindless_slot() and mark_used().
+        crd_nodiscard crd_module std::uint32_t         bindless_slot() const noexcept;
+        // Marks a streamed texture as used this frame. Textures not marked every frame they are sampled are the
+        // first to lose their top levels.
+                      crd_module void                  mark_used() const noexcept;
                       crd_module void                  destroy() noexcept;
     };
-    crd_nodiscard crd_module Async<StaticTexture> request_static_texture(Renderer&, std::string&&, TextureFormat) noexcept;
+    crd_nodiscard crd_module Async<StaticTexture> request_static_texture(Renderer&, std::string&&, TextureFormat, TextureLoad = texture_load_full) noexcept;
 } // namespace crd
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <corundum/core/static_texture.hpp>
+
+#include <corundum/detail/forward.hpp>
+#include <corundum/detail/macros.hpp>
+
+#include <unordered_map>
+#include <cstdint>
+#include <string>
+#include <mutex>
+
+namespace crd {
+    // Renderer-wide textures, keyed by canonical path and format. Every model referencing the same file shares
+    // one Async, including while it is still loading, and the last reference destroys it.
+    struct TextureRegistry {
+        struct Entry {
+            Async<StaticTexture>* texture;
+            std::uint32_t references;
+        };
+        std::unordered_map<std::string, Entry> entries;
+        std::unordered_map<const Async<StaticTexture>*, std::string> keys;
+        std::mutex lock;
+
+        // Takes a reference to the texture, requesting it if nobody holds one yet.
+        crd_nodiscard crd_module Async<StaticTexture>* acquire(Renderer&, std::string&&, TextureFormat, TextureLoad = texture_load_full) noexcept;
+        // Drops a reference, the last one waits for the request if it is still running and destroys the texture.
+                      crd_module void                  release(Async<StaticTexture>*) noexcept;
+    };
+
+    crd_nodiscard crd_module TextureRegistry* make_texture_registry() noexcept;
+                  crd_module void             destroy_texture_registry(TextureRegistry*&) noexcept;
+} // namespace crd
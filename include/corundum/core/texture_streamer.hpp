@@ -0,0 +1,112 @@
+#pragma once
+
+#include <corundum/core/constants.hpp>
+#include <corundum/core/image.hpp>
+
+#include <corundum/detail/file_view.hpp>
+#include <corundum/detail/forward.hpp>
+#include <corundum/detail/macros.hpp>
+
+#include <vulkan/vulkan.h>
+#include <vk_mem_alloc.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <atomic>
+#include <deque>
+#include <mutex>
+
+namespace crd {
+    enum ResidencyState {
+        residency_idle,
+        // Waiting in TextureStreamer::pending for its next level.
+        residency_queued,
+        // A level upload or a reallocation is running on a fiber.
+        residency_busy
+    };
+
+    // Every level of a streamed texture, kept for its whole lifetime so that levels dropped under memory
+    // pressure can be streamed back in: either the mapped .crdt container or the RGBA8 chain built on the CPU.
+    struct TextureSource {
+        dtl::FileView file;
+        std::vector<std::uint8_t> chain;
+        const std::uint8_t* data;
+        // Offset of every level into data, followed by the end of the last one.
+        std::vector<std::size_t> offsets;
+        std::uint32_t width;
+        std::uint32_t height;
+    };
+
+    // Levels are numbered in the full chain. The allocation only holds the levels [base, mips), and only
+    // [resident, mips) were uploaded so far. Everything but the atomics is guarded by the streamer lock.
+    struct TextureResidency {
+        const Context* context;
+        TextureSource source;
+        Image image;
+        // views[i] covers the allocated levels [base + i, mips), so the GPU never samples a missing level.
+        std::vector<VkImageView> views;
+        std::atomic<VkImageView> view;
+        std::uint32_t mips;
+        std::uint32_t base;
+        // Levels from here on are never dropped.
+        std::uint32_t tail;
+        std::uint32_t resident;
+        // Next level to stream in, or the new base of a reallocation.
+        std::uint32_t next;
+        std::atomic<std::uint64_t> last_used;
+        // Once published, every change of view is queued for this bindless slot too.
+        BindlessTable* bindless;
+        std::uint32_t slot;
+        VkSampler sampler;
+        ResidencyState state;
+        bool cancelled;
+    };
+
+    // Keeps streamed textures within the device local heap budget. Every frame it:
+    // - releases the allocations retired at least `in_flight` frames ago,
+    // - reallocates the least recently used textures without their top level while over budget, or
+    //   gives recently used textures their full chain back once there is room for it again,
+    // - hands at most `frame_budget` bytes of levels to the task scheduler, a single level larger than
+    //   the budget still goes through alone. A texture only requeues once its previous level has landed.
+    struct TextureStreamer {
+        struct Retired {
+            Image image;
+            std::vector<VkImageView> views;
+            std::uint64_t frame;
+        };
+        VmaAllocator allocator;
+        ftl::TaskScheduler* scheduler;
+        std::vector<TextureResidency*> textures;
+        std::deque<TextureResidency*> pending;
+        std::vector<Retired> retired;
+        std::condition_variable idle;
+        std::atomic<std::uint64_t> frame;
+        std::size_t frame_budget;
+        // Device local bytes textures may grow into, 0 follows the budget reported by the driver.
+        std::size_t memory_budget;
+        std::uint32_t busy;
+        std::mutex lock;
+
+        // Whether the device local heaps can take this many more bytes without going over budget.
+        crd_nodiscard crd_module bool          has_room(std::size_t) const noexcept;
+                      crd_module void          track(TextureResidency*) noexcept;
+        // Gives a texture a bindless slot holding its current view, and keeps it updated from then on.
+        crd_nodiscard crd_module std::uint32_t publish(TextureResidency*, BindlessTable*, VkSampler) noexcept;
+                      crd_module void          begin_frame() noexcept;
+        // Stops tracking a texture, waiting for the work currently running on it.
+                      crd_module void          release(TextureResidency*) noexcept;
+    };
+
+    crd_nodiscard crd_module TextureStreamer*  make_texture_streamer(const Context&, std::size_t = streaming_budget, std::size_t = 0) noexcept;
+                  crd_module void              destroy_texture_streamer(TextureStreamer*&) noexcept;
+    // Takes ownership of the image, which holds the levels [base, mips) of the source, and of the source.
+    // The levels [resident, mips) must already be uploaded, they are never dropped.
+    crd_nodiscard crd_module TextureResidency* make_texture_residency(const Context&, const Image&, TextureSource&&, std::uint32_t, std::uint32_t) noexcept;
+                  crd_module void              destroy_texture_residency(TextureResidency*&) noexcept;
+
+    // Copies the levels [first, first + offsets.size()) from staging, `offsets` holding one staging offset per level,
+    // and hands them to the graphics queue already in SHADER_READ_ONLY_OPTIMAL. Suspends the calling fiber until done.
+                  crd_module void              upload_mips(const Context&, const Image&, const StagingBlock&, const std::vector<std::size_t>&, std::uint32_t = 0) noexcept;
+} // namespace crd
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <corundum/core/command_buffer.hpp>
+
+#include <corundum/detail/forward.hpp>
+#include <corundum/detail/macros.hpp>
+
+#include <vulkan/vulkan.h>
+
+#include <condition_variable>
+#include <functional>
+#include <cstddef>
+#include <thread>
+#include <vector>
+#include <mutex>
+
+namespace crd {
+    struct UploadJob {
+        // Records copies and the queue family release, executed on the transfer queue.
+        std::function<void(CommandBuffer&)> transfer;
+        // Records the queue family acquire and any follow-up work, executed on the graphics queue. Optional.
+        std::function<void(CommandBuffer&)> acquire;
+        std::size_t bytes;
+        ftl::WaitGroup* waiter;
+    };
+
+    // Gathers the uploads of every concurrent asset request for a short window (or until enough
+    // bytes are queued), then records them into one transfer and one graphics submission.
+    struct UploadBatcher {
+        VkDevice device;
+        Queue* transfer;
+        Queue* graphics;
+        VkCommandPool transfer_pool;
+        VkCommandPool graphics_pool;
+        CommandBuffer transfer_cmd;
+        CommandBuffer acquire_cmd;
+        std::thread flusher;
+        std::condition_variable wake;
+        std::vector<UploadJob> pending;
+        std::size_t pending_bytes;
+        std::mutex lock;
+        bool running;
+
+        crd_module void enqueue(UploadJob&&) noexcept;
+    };
+
+    crd_nodiscard crd_module UploadBatcher* make_upload_batcher(const Context&) noexcept;
+                  crd_module void           destroy_upload_batcher(const Context&, UploadBatcher*&) noexcept;
+
+    // Suspends the calling fiber until the batch containing this job has completed on the GPU.
+                  crd_module void           await_upload(const Context&, UploadJob&&) noexcept;
+} // namespace crd
@@ -13,6 +13,10 @@ namespace crd {
         return container.size() * sizeof(typename C::value_type);
     }
 
+    crd_nodiscard crd_module constexpr std::size_t align_up(std::size_t value, std::size_t alignment) noexcept {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
     template <typename T>
     crd_nodiscard crd_module VkDeviceAddress device_address(const Context&, const T&) noexcept;
 } // namespace crd
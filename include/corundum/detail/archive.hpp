@@ -0,0 +1,72 @@
+#pragma once
+
+#include <corundum/detail/file_view.hpp>
+#include <corundum/detail/forward.hpp>
+#include <corundum/detail/macros.hpp>
+
+#include <unordered_map>
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace crd::dtl {
+    constexpr auto archive_magic = 0x50445243u; // "CRDP"
+    constexpr auto archive_version = 1u;
+    constexpr auto archive_block_size = 256u * 1024;
+    // Set in a block size when the block is stored as is, because LZ4 did not make it any smaller.
+    constexpr auto archive_block_stored = 0x80000000u;
+
+    // Layout of a .crdp file: header, one ArchiveEntry per file, the compressed size of every block, the path
+    // table, then the blocks of every entry back to back, each entry starting on a 16 byte boundary. Every block
+    // holds archive_block_size bytes of its file (the last one less) and decompresses on its own.
+    struct ArchiveHeader {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint32_t entries;
+        std::uint32_t block_size;
+        std::uint64_t blocks;
+        std::uint64_t strings_size;
+    };
+
+    struct ArchiveEntry {
+        // Of the first block, relative to the start of the file.
+        std::uint64_t offset;
+        // Decompressed.
+        std::uint64_t size;
+        std::uint32_t first_block;
+        std::uint32_t block_count;
+        // Path relative to the packed directory with '/' separators, not null terminated.
+        std::uint32_t path_offset;
+        std::uint32_t path_size;
+    };
+
+    // A .crdp file mapped once. Paths are looked up relative to `root`, the directory the archive stands in for.
+    struct Archive {
+        FileView file;
+        ftl::TaskScheduler* scheduler;
+        // Both absolute, relative lookups are resolved against the working directory at the time of mounting.
+        std::string root;
+        std::string working_directory;
+        const ArchiveEntry* entries;
+        const std::uint32_t* blocks;
+        std::unordered_map<std::string_view, const ArchiveEntry*> lookup;
+    };
+
+    // Null when the file is missing or is not a valid archive.
+    crd_nodiscard Archive*                  make_archive(const char*, const char*, ftl::TaskScheduler*) noexcept;
+                  void                      destroy_archive(Archive*&) noexcept;
+    crd_nodiscard const ArchiveEntry*       find_entry(const Archive&, const char*) noexcept;
+    // The entry straight from the mapping when every block of it is stored, null otherwise.
+    crd_nodiscard const std::uint8_t*       stored_entry(const Archive&, const ArchiveEntry&) noexcept;
+    // Decompresses every block of the entry into the destination, in parallel on the archive's scheduler.
+    // False when a block is corrupted, the destination is then left partially written.
+    crd_nodiscard bool                      extract_entry(const Archive&, const ArchiveEntry&, std::uint8_t*) noexcept;
+    // Packs the files (relative paths and their contents) into a .crdp container.
+    crd_nodiscard std::vector<std::uint8_t> pack_archive(const std::vector<std::string>&, const std::vector<std::vector<std::uint8_t>>&) noexcept;
+
+    // make_file_view and file_exists resolve paths through the mounted archive first, null unmounts it.
+                  void                      mount_archive(Archive*) noexcept;
+    crd_nodiscard Archive*                  mounted_archive() noexcept;
+} // namespace crd::dtl
@@ -2,6 +2,7 @@
 
 #include <corundum/detail/macros.hpp>
 
+#include <cstdint>
 #include <cstddef>
 
 namespace crd::dtl {
@@ -14,8 +15,13 @@ namespace crd::dtl {
 #endif
         const void* data;
         std::size_t size;
+        // Decompressed archive entry, views of stored entries point into the archive mapping and own nothing.
+        std::uint8_t* owned;
+        bool archived;
     };
 
+    // Resolves the path through the mounted archive first, see mount_archive.
     crd_nodiscard FileView make_file_view(const char*) noexcept;
                   void     destroy_file_view(FileView&) noexcept;
+    crd_nodiscard bool     file_exists(const char*) noexcept;
 } // namespace crd::dtl
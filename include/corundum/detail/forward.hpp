@@ -8,9 +8,14 @@ struct GLFWwindow;
 
 namespace ftl {
     class TaskScheduler;
+    class WaitGroup;
 } // namespace ftl
 
 namespace crd {
+    namespace dtl {
+        struct Archive;
+    } // namespace crd::dtl
+
     struct Context;
     struct Swapchain;
     struct Image;
@@ -21,14 +26,29 @@ namespace crd {
     struct GraphicsPipeline;
     struct ComputePipeline;
     struct Queue;
+    struct CompletionService;
+    struct StagingRing;
+    struct StagingBlock;
+    struct UploadBatcher;
+    struct FileReader;
+    struct GeometryArena;
+    struct GeometryHeap;
+    struct GeometryRange;
     struct CommandBuffer;
     struct Renderer;
     struct StaticBuffer;
     struct StaticMesh;
+    struct MeshBuilder;
     struct StaticTexture;
+    struct TextureResidency;
+    struct TextureStreamer;
+    struct TextureRegistry;
+    struct BindlessTable;
     struct StaticModel;
     struct DescriptorBinding;
     struct DescriptorSetLayout;
+    struct DescriptorBatcher;
+    struct DescriptorAllocator;
 #if defined(crd_enable_raytracing)
     struct AccelerationStructure;
 #endif
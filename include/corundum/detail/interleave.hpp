@@ -0,0 +1,20 @@
+#pragma once
+
+#include <corundum/detail/macros.hpp>
+
+#include <cstddef>
+
+namespace crd::dtl {
+    // Separate attribute arrays of one mesh, each one tightly packed float3 (uvs only use x and y).
+    // Absent attributes are null and written as zeros.
+    struct VertexStreams {
+        const float* positions;
+        const float* normals;
+        const float* uvs;
+        const float* tangents;
+        const float* bitangents;
+    };
+
+    // Writes the 14-float interleaved vertex layout, the kernel is picked once per call from the present attributes.
+    void interleave_vertices(const VertexStreams&, std::size_t, float*) noexcept;
+} // namespace crd::dtl
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <corundum/detail/macros.hpp>
+
+#include <cstdint>
+#include <cstddef>
+
+namespace crd::dtl {
+    struct IoCompletion {
+        std::uint64_t user;
+        // Bytes read, or a negated errno.
+        std::int32_t result;
+    };
+
+    // Thin io_uring wrapper over the raw syscalls (no liburing). Only exists on Linux, make_io_ring reports
+    // failure everywhere else and on kernels or sandboxes without io_uring. The submission side and the
+    // completion side may be driven from two different threads, but each one from a single thread at a time.
+    struct IoRing {
+        int handle;
+        std::uint32_t depth;
+        void* sq_ring;
+        std::size_t sq_ring_size;
+        void* cq_ring;
+        std::size_t cq_ring_size;
+        void* sqes;
+        std::size_t sqes_size;
+        std::uint32_t* sq_head;
+        std::uint32_t* sq_tail;
+        std::uint32_t* sq_mask;
+        std::uint32_t* sq_array;
+        std::uint32_t* cq_head;
+        std::uint32_t* cq_tail;
+        std::uint32_t* cq_mask;
+        void* cqes;
+        // Entries written since the last submit.
+        std::uint32_t queued;
+    };
+
+    crd_nodiscard bool          make_io_ring(IoRing&, std::uint32_t) noexcept;
+                  void          destroy_io_ring(IoRing&) noexcept;
+    // Both return false when the submission queue is full, nothing reaches the kernel before submit_io_ring.
+    crd_nodiscard bool          queue_read(IoRing&, int, void*, std::uint32_t, std::uint64_t, std::uint64_t) noexcept;
+    crd_nodiscard bool          queue_nop(IoRing&, std::uint64_t) noexcept;
+                  void          submit_io_ring(IoRing&) noexcept;
+    // Blocks until at least one completion is available, then moves up to `count` of them out of the ring.
+    crd_nodiscard std::uint32_t wait_io_ring(IoRing&, IoCompletion*, std::uint32_t) noexcept;
+} // namespace crd::dtl
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <corundum/detail/macros.hpp>
+
+#include <cstdint>
+#include <cstddef>
+
+namespace crd::dtl {
+    // Worst case size of a compressed block of the given size.
+    crd_nodiscard std::size_t lz4_bound(std::size_t) noexcept;
+    // Greedy single pass compressor producing the LZ4 block format. Returns the compressed size, or 0 when the
+    // destination is too small (incompressible input expands slightly, see lz4_bound).
+    crd_nodiscard std::size_t lz4_compress(const std::uint8_t*, std::size_t, std::uint8_t*, std::size_t) noexcept;
+    // Decodes an LZ4 block which must decompress to exactly the destination size, false on malformed input.
+    crd_nodiscard bool        lz4_decompress(const std::uint8_t*, std::size_t, std::uint8_t*, std::size_t) noexcept;
+} // namespace crd::dtl
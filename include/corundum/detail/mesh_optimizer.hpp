@@ -0,0 +1,24 @@
+#pragma once
+
+#include <corundum/detail/macros.hpp>
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace crd::dtl {
+    // Size of the FIFO cache used to score and simulate post-transform cache behaviour.
+    constexpr auto vertex_cache_size = 16u;
+
+    // Merges bitwise identical vertices and rewrites indices to point at the survivors.
+    void weld_vertices(std::vector<std::uint8_t>&, std::vector<std::uint32_t>&, std::size_t) noexcept;
+    // Reorders triangles for the post-transform cache, "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw" (Tipsify).
+    void optimize_vertex_cache(std::vector<std::uint32_t>&, std::size_t) noexcept;
+    // Reorders vertices by first use in the index buffer, unreferenced vertices are dropped.
+    void optimize_vertex_fetch(std::vector<std::uint8_t>&, std::vector<std::uint32_t>&, std::size_t) noexcept;
+    // Average cache miss ratio: simulated transforms per triangle.
+    crd_nodiscard float compute_acmr(const std::vector<std::uint32_t>&, std::size_t) noexcept;
+
+    // Runs every stage above in order and reports the before/after vertex count and ACMR.
+    void optimize_mesh(std::vector<std::uint8_t>&, std::vector<std::uint32_t>&, std::size_t) noexcept;
+} // namespace crd::dtl
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+
+namespace crd::dtl {
+    constexpr auto cooked_model_magic = 0x4D445243u; // "CRDM"
+    constexpr auto cooked_model_version = 2u;
+    constexpr auto cooked_no_texture = ~0u;
+
+    // Layout of a .crdm file: header, one CookedSubmesh per mesh, one CookedInstance per node reference, the texture
+    // path table, then the geometry of every submesh, each starting on a 16 byte boundary. A submesh's vertices are
+    // directly followed by its indices, exactly as StaticMesh uploads them, so each one is a single copy into staging.
+    struct CookedModelHeader {
+        std::uint32_t magic;
+        std::uint32_t version;
+        // VertexFormat the vertices were encoded with.
+        std::uint32_t format;
+        std::uint32_t submeshes;
+        std::uint32_t instances;
+        std::uint32_t reserved;
+        // Null terminated paths relative to the model's directory, CookedSubmesh::textures index into this range.
+        std::uint64_t strings_offset;
+        std::uint64_t strings_size;
+        // Enclose every instance in model space.
+        float min[3];
+        float max[3];
+    };
+
+    struct CookedSubmesh {
+        // Relative to the start of the file.
+        std::uint64_t offset;
+        std::uint32_t vertex_count;
+        std::uint32_t index_count;
+        // VkIndexType, as picked by narrowed_index_type for the cooking build.
+        std::uint32_t index_type;
+        // Diffuse, normal and specular, as offsets into the path table or cooked_no_texture.
+        std::uint32_t textures[3];
+        // In mesh space.
+        float min[3];
+        float max[3];
+    };
+
+    struct CookedInstance {
+        std::uint32_t submesh;
+        // Column major node to model transform.
+        float transform[16];
+    };
+} // namespace crd::dtl
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <corundum/detail/forward.hpp>
+#include <corundum/detail/macros.hpp>
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace crd::dtl {
+    enum TextureCodec : std::uint32_t {
+        // Opaque RGB, 8 bytes per 4x4 block.
+        texture_codec_bc1,
+        // RGB with interpolated alpha, 16 bytes per block.
+        texture_codec_bc3,
+        // Two independent channels (normal maps), 16 bytes per block.
+        texture_codec_bc5,
+        // RGBA, mode 6 only, 16 bytes per block.
+        texture_codec_bc7
+    };
+
+    constexpr auto cooked_texture_magic = 0x54445243u; // "CRDT"
+    constexpr auto cooked_texture_version = 1u;
+
+    // Layout of a .crdt file: header, one CookedMip per level, then the block data of every level
+    // from the largest to the smallest, each level starting on a 16 byte boundary.
+    struct CookedTextureHeader {
+        std::uint32_t magic;
+        std::uint32_t version;
+        TextureCodec codec;
+        // Whether mips were filtered in linear space, the runtime picks the _SRGB or _UNORM view of the blocks.
+        std::uint32_t srgb;
+        std::uint32_t width;
+        std::uint32_t height;
+        std::uint32_t mips;
+        std::uint32_t reserved;
+    };
+
+    struct CookedMip {
+        // Relative to the start of the file.
+        std::uint64_t offset;
+        std::uint64_t size;
+    };
+
+    crd_nodiscard std::size_t               block_size(TextureCodec) noexcept;
+    crd_nodiscard std::uint32_t             mip_count(std::uint32_t, std::uint32_t) noexcept;
+    // Byte offset of every level of a tightly packed RGBA8 mip chain, followed by the size of the whole chain.
+    crd_nodiscard std::vector<std::size_t>  mip_chain_offsets(std::uint32_t, std::uint32_t) noexcept;
+    // Box filters the full RGBA8 chain into the destination, laid out as mip_chain_offsets (level 0 is copied).
+    // sRGB levels are averaged in linear space. Given a scheduler, the rows of each level are split across its fibers.
+                  void                      build_mips(const std::uint8_t*, std::uint32_t, std::uint32_t, bool, std::uint8_t*, ftl::TaskScheduler* = nullptr) noexcept;
+    crd_nodiscard std::vector<std::uint8_t> compress_blocks(const std::uint8_t*, std::uint32_t, std::uint32_t, TextureCodec) noexcept;
+    // Builds and compresses the full mip chain of an RGBA8 image into a .crdt container.
+    crd_nodiscard std::vector<std::uint8_t> cook_texture(const std::uint8_t*, std::uint32_t, std::uint32_t, bool, TextureCodec) noexcept;
+} // namespace crd::dtl
@@ -39,6 +39,15 @@ namespace crd {
         return async;
     }
 
+    template <typename T>
+    crd_nodiscard crd_module Async<T> make_async(T&& value) noexcept {
+        crd_profile_scoped();
+        Async<T> async;
+        new (&async.storage) T(std::move(value));
+        async.tag = task_tag_completed;
+        return async;
+    }
+
     template <typename T>
     Async<T>::~Async() noexcept {
         crd_profile_scoped();
@@ -120,4 +129,8 @@ namespace crd {
     template crd_module Async<StaticMesh> make_async(std::future<StaticMesh>&&);
     template crd_module Async<StaticTexture> make_async(std::future<StaticTexture>&&);
     template crd_module Async<StaticModel> make_async(std::future<StaticModel>&&);
+
+    template crd_module Async<StaticMesh> make_async(StaticMesh&&);
+    template crd_module Async<StaticTexture> make_async(StaticTexture&&);
+    template crd_module Async<StaticModel> make_async(StaticModel&&);
 } // namespace crd
@@ -0,0 +1,182 @@
+#include <corundum/core/bindless.hpp>
+#include <corundum/core/context.hpp>
+
+#if defined(crd_enable_profiling)
+    #include <Tracy.hpp>
+#endif
+
+#include <spdlog/spdlog.h>
+
+#include <vulkan/vulkan.h>
+
+#include <algorithm>
+#include <vector>
+#include <array>
+
+namespace crd {
+    static inline void write_slots(VkDevice device, VkDescriptorSet set, const BindlessTable::Write* writes, std::size_t count) noexcept {
+        crd_profile_scoped();
+        std::vector<VkWriteDescriptorSet> updates(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            auto& update = updates[i];
+            update.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            update.pNext = nullptr;
+            update.dstSet = set;
+            update.dstBinding = 0;
+            update.dstArrayElement = writes[i].slot;
+            update.descriptorCount = 1;
+            update.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            update.pImageInfo = &writes[i].info;
+            update.pBufferInfo = nullptr;
+            update.pTexelBufferView = nullptr;
+        }
+        vkUpdateDescriptorSets(device, updates.size(), updates.data(), 0, nullptr);
+    }
+
+    crd_nodiscard crd_module std::uint32_t BindlessTable::allocate(VkDescriptorImageInfo info) noexcept {
+        crd_profile_scoped();
+        // Updates to the same set must be externally synchronized, even for distinct slots.
+        std::lock_guard<std::mutex> guard(lock);
+        std::uint32_t slot;
+        crd_likely_if(!available.empty()) {
+            slot = available.back();
+            available.pop_back();
+        } else {
+            crd_assert(next < capacity, "bindless table is full");
+            slot = next++;
+        }
+        // Fresh or recycled, no pending frame uses the slot in any copy.
+        const Write write = { slot, info };
+        for (auto each : sets) {
+            write_slots(device, each, &write, 1);
+        }
+        return slot;
+    }
+
+    crd_module void BindlessTable::update(std::uint32_t slot, VkDescriptorImageInfo info) noexcept {
+        crd_profile_scoped();
+        std::lock_guard<std::mutex> guard(lock);
+        for (auto& writes : queued) {
+            writes.push_back({ slot, info });
+        }
+    }
+
+    crd_module void BindlessTable::release(std::uint32_t slot) noexcept {
+        crd_profile_scoped();
+        crd_unlikely_if(slot == bindless_null_slot) {
+            return;
+        }
+        std::lock_guard<std::mutex> guard(lock);
+        // Writes still queued for the slot may name views destroyed right after, no copy may apply them anymore.
+        for (auto& writes : queued) {
+            std::erase_if(writes, [slot](const Write& each) noexcept {
+                return each.slot == slot;
+            });
+        }
+        retired.push_back({ slot, frame });
+    }
+
+    crd_module void BindlessTable::begin_frame(std::uint32_t index) noexcept {
+        crd_profile_scoped();
+        std::lock_guard<std::mutex> guard(lock);
+        current = index;
+        frame++;
+        // Queued in order, the latest write to a slot lands last.
+        auto& writes = queued[index];
+        crd_unlikely_if(!writes.empty()) {
+            write_slots(device, sets[index], writes.data(), writes.size());
+            writes.clear();
+        }
+        // Every copy applied the writes queued before a release by now, a recycled slot is idle everywhere.
+        const auto expired = std::partition(retired.begin(), retired.end(), [this](const Retired& each) noexcept {
+            return frame - each.frame < in_flight;
+        });
+        for (auto each = expired; each != retired.end(); ++each) {
+            available.emplace_back(each->slot);
+        }
+        retired.erase(expired, retired.end());
+    }
+
+    crd_nodiscard crd_module VkDescriptorSet BindlessTable::current_set() const noexcept {
+        crd_profile_scoped();
+        return sets[current];
+    }
+
+    crd_nodiscard crd_module BindlessTable* make_bindless_table(const Context& context, std::uint32_t capacity) noexcept {
+        crd_profile_scoped();
+        VkPhysicalDeviceDescriptorIndexingProperties indexing_props = {};
+        indexing_props.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES;
+        VkPhysicalDeviceProperties2 properties = {};
+        properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        properties.pNext = &indexing_props;
+        vkGetPhysicalDeviceProperties2(context.gpu.handle, &properties);
+        auto table = new BindlessTable();
+        table->device = context.device;
+        table->next = bindless_null_slot + 1;
+        table->capacity = std::min({
+            capacity,
+            indexing_props.maxDescriptorSetUpdateAfterBindSampledImages,
+            indexing_props.maxPerStageDescriptorUpdateAfterBindSampledImages
+        });
+        table->current = 0;
+        table->frame = 0;
+
+        const VkDescriptorBindingFlags binding_flags =
+            VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+            VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+            VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+        VkDescriptorSetLayoutBindingFlagsCreateInfo binding_flags_info;
+        binding_flags_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+        binding_flags_info.pNext = nullptr;
+        binding_flags_info.bindingCount = 1;
+        binding_flags_info.pBindingFlags = &binding_flags;
+
+        VkDescriptorSetLayoutBinding binding;
+        binding.binding = 0;
+        binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        binding.descriptorCount = table->capacity;
+        binding.stageFlags = VK_SHADER_STAGE_ALL;
+        binding.pImmutableSamplers = nullptr;
+
+        VkDescriptorSetLayoutCreateInfo layout_info;
+        layout_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        layout_info.pNext = &binding_flags_info;
+        layout_info.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+        layout_info.bindingCount = 1;
+        layout_info.pBindings = &binding;
+        crd_vulkan_check(vkCreateDescriptorSetLayout(context.device, &layout_info, nullptr, &table->layout));
+
+        VkDescriptorPoolSize pool_size;
+        pool_size.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        pool_size.descriptorCount = table->capacity * in_flight;
+
+        VkDescriptorPoolCreateInfo pool_info;
+        pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        pool_info.pNext = nullptr;
+        pool_info.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+        pool_info.maxSets = in_flight;
+        pool_info.poolSizeCount = 1;
+        pool_info.pPoolSizes = &pool_size;
+        crd_vulkan_check(vkCreateDescriptorPool(context.device, &pool_info, nullptr, &table->pool));
+
+        std::array<VkDescriptorSetLayout, in_flight> layouts;
+        layouts.fill(table->layout);
+        VkDescriptorSetAllocateInfo allocate_info;
+        allocate_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocate_info.pNext = nullptr;
+        allocate_info.descriptorPool = table->pool;
+        allocate_info.descriptorSetCount = in_flight;
+        allocate_info.pSetLayouts = layouts.data();
+        crd_vulkan_check(vkAllocateDescriptorSets(context.device, &allocate_info, table->sets.data()));
+        spdlog::info("bindless texture table created, slots: {}", table->capacity);
+        return table;
+    }
+
+    crd_module void destroy_bindless_table(BindlessTable*& table) noexcept {
+        crd_profile_scoped();
+        vkDestroyDescriptorPool(table->device, table->pool, nullptr);
+        vkDestroyDescriptorSetLayout(table->device, table->layout, nullptr);
+        delete table;
+        table = nullptr;
+    }
+} // namespace crd
@@ -1,8 +1,10 @@
+#include <corundum/core/descriptor_batcher.hpp>
 #include <corundum/core/command_buffer.hpp>
 #include <corundum/core/descriptor_set.hpp>
 #include <corundum/core/static_buffer.hpp>
 #include <corundum/core/static_mesh.hpp>
 #include <corundum/core/render_pass.hpp>
+#include <corundum/core/bindless.hpp>
 #include <corundum/core/constants.hpp>
 #include <corundum/core/dispatch.hpp>
 #include <corundum/core/pipeline.hpp>
@@ -13,9 +15,19 @@
     #include <Tracy.hpp>
 #endif
 
+#include <algorithm>
 #include <vector>
 
 namespace crd {
+    crd_nodiscard static inline VkPipelineBindPoint bind_point(const Pipeline& pipeline) noexcept {
+        switch (pipeline.type) {
+            case Pipeline::type_graphics:   return VK_PIPELINE_BIND_POINT_GRAPHICS;
+            case Pipeline::type_compute:    return VK_PIPELINE_BIND_POINT_COMPUTE;
+            case Pipeline::type_raytracing: return VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR;
+        }
+        crd_unreachable();
+    }
+
     crd_nodiscard crd_module std::vector<CommandBuffer> make_command_buffers(const Context& context, CommandBuffer::CreateInfo&& info) noexcept {
         crd_profile_scoped();
         VkCommandBufferAllocateInfo allocate_info;
@@ -76,6 +88,9 @@ namespace crd {
         begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
         begin_info.pInheritanceInfo = nullptr;
         crd_vulkan_check(vkBeginCommandBuffer(handle, &begin_info));
+        bound_vertices = nullptr;
+        bound_indices = nullptr;
+        bound_index_type = VK_INDEX_TYPE_UINT32;
         return *this;
     }
 
@@ -159,26 +174,23 @@ namespace crd {
 
     crd_module CommandBuffer& CommandBuffer::bind_pipeline(const Pipeline& pipeline) noexcept {
         crd_profile_scoped();
-        VkPipelineBindPoint bind_point;
-        switch (pipeline.type) {
-            case Pipeline::type_graphics:   bind_point = VK_PIPELINE_BIND_POINT_GRAPHICS;        break;
-            case Pipeline::type_compute:    bind_point = VK_PIPELINE_BIND_POINT_COMPUTE;         break;
-            case Pipeline::type_raytracing: bind_point = VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR; break;
-        }
-        vkCmdBindPipeline(handle, bind_point, pipeline.handle);
+        vkCmdBindPipeline(handle, bind_point(pipeline), pipeline.handle);
         active_pipeline = &pipeline;
         return *this;
     }
 
     crd_module CommandBuffer& CommandBuffer::bind_descriptor_set(std::uint32_t index, const DescriptorSet<1>& set) noexcept {
         crd_profile_scoped();
-        VkPipelineBindPoint bind_point;
-        switch (active_pipeline->type) {
-            case Pipeline::type_graphics:   bind_point = VK_PIPELINE_BIND_POINT_GRAPHICS;        break;
-            case Pipeline::type_compute:    bind_point = VK_PIPELINE_BIND_POINT_COMPUTE;         break;
-            case Pipeline::type_raytracing: bind_point = VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR; break;
-        }
-        vkCmdBindDescriptorSets(handle, bind_point, active_pipeline->layout.pipeline, index, 1, &set.handle, 0, nullptr);
+        // A set may not be updated once bound, so every write recorded so far goes out now, in one call.
+        set.context->descriptors->flush();
+        vkCmdBindDescriptorSets(handle, bind_point(*active_pipeline), active_pipeline->layout.pipeline, index, 1, &set.handle, 0, nullptr);
+        return *this;
+    }
+
+    crd_module CommandBuffer& CommandBuffer::bind_descriptor_set(std::uint32_t index, const BindlessTable& table) noexcept {
+        crd_profile_scoped();
+        const auto set = table.current_set();
+        vkCmdBindDescriptorSets(handle, bind_point(*active_pipeline), active_pipeline->layout.pipeline, index, 1, &set, 0, nullptr);
         return *this;
     }
 
@@ -186,19 +198,28 @@ namespace crd {
         crd_profile_scoped();
         VkDeviceSize offset = 0;
         vkCmdBindVertexBuffers(handle, 0, 1, &vertex.handle, &offset);
+        bound_vertices = vertex.handle;
         return *this;
     }
 
-    crd_module CommandBuffer& CommandBuffer::bind_index_buffer(const StaticBuffer& index) noexcept {
+    crd_module CommandBuffer& CommandBuffer::bind_index_buffer(const StaticBuffer& index, VkIndexType type) noexcept {
         crd_profile_scoped();
-        vkCmdBindIndexBuffer(handle, index.handle, 0, VK_INDEX_TYPE_UINT32);
+        vkCmdBindIndexBuffer(handle, index.handle, 0, type);
+        bound_indices = index.handle;
+        bound_index_type = type;
         return *this;
     }
 
     crd_module CommandBuffer& CommandBuffer::bind_static_mesh(const StaticMesh& mesh) noexcept {
         crd_profile_scoped();
-        bind_vertex_buffer(mesh.geometry);
-        bind_index_buffer(mesh.indices);
+        // Meshes sharing an arena block only differ by their offsets, which are supplied by the draw.
+        crd_unlikely_if(bound_vertices != mesh.geometry->block->buffer.handle) {
+            bind_vertex_buffer(mesh.geometry->block->buffer);
+        }
+        // 16 and 32-bit ranges may share a block, so the index type counts as well.
+        crd_unlikely_if(bound_indices != mesh.indices->block->buffer.handle || bound_index_type != mesh.index_type) {
+            bind_index_buffer(mesh.indices->block->buffer, mesh.index_type);
+        }
         return *this;
     }
 
@@ -245,6 +266,16 @@ namespace crd {
         return *this;
     }
 
+    crd_module CommandBuffer& CommandBuffer::draw_static_mesh(const StaticMesh& mesh, std::uint32_t instances, std::uint32_t first_instance) noexcept {
+        crd_profile_scoped();
+        return bind_static_mesh(mesh).draw_indexed(
+            mesh.index_count,
+            instances,
+            mesh.indices->offset / mesh.indices->stride,
+            mesh.geometry->offset / mesh.geometry->stride,
+            first_instance);
+    }
+
     crd_module CommandBuffer& CommandBuffer::trace_rays(std::uint32_t x, std::uint32_t y) noexcept {
 #if defined(crd_enable_raytracing)
         crd_profile_scoped();
@@ -336,6 +367,16 @@ namespace crd {
         return *this;
     }
 
+    crd_module CommandBuffer& CommandBuffer::copy_buffer(const BufferCopy& info) noexcept {
+        crd_profile_scoped();
+        VkBufferCopy region;
+        region.srcOffset = info.source_offset;
+        region.dstOffset = info.dest_offset;
+        region.size = info.size;
+        vkCmdCopyBuffer(handle, info.source->handle, info.dest->handle, 1, &region);
+        return *this;
+    }
+
     crd_module CommandBuffer& CommandBuffer::copy_buffer_to_image(const StaticBuffer& source, const Image& dest) noexcept {
         crd_profile_scoped();
         VkBufferImageCopy region;
@@ -352,6 +393,26 @@ namespace crd {
         return *this;
     }
 
+    crd_module CommandBuffer& CommandBuffer::copy_buffer_to_image(const BufferImageCopy& info) noexcept {
+        crd_profile_scoped();
+        VkBufferImageCopy region;
+        region.bufferOffset = info.source_offset;
+        region.bufferRowLength = 0;
+        region.bufferImageHeight = 0;
+        region.imageSubresource.aspectMask = info.dest->aspect;
+        region.imageSubresource.mipLevel = info.mip;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount = 1;
+        region.imageOffset = { 0, 0, 0 };
+        region.imageExtent = {
+            std::max(info.dest->width >> info.mip, 1u),
+            std::max(info.dest->height >> info.mip, 1u),
+            1
+        };
+        vkCmdCopyBufferToImage(handle, info.source->handle, info.dest->handle, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+        return *this;
+    }
+
     crd_module CommandBuffer& CommandBuffer::barrier(const BufferMemoryBarrier& info) noexcept {
         crd_profile_scoped();
         VkBufferMemoryBarrier barrier;
@@ -470,7 +531,7 @@ namespace crd {
         barrier.dstQueueFamilyIndex = dest.family;
         barrier.image = info.image->handle;
         barrier.subresourceRange.aspectMask = info.image->aspect;
-        barrier.subresourceRange.baseMipLevel = 0;
+        barrier.subresourceRange.baseMipLevel = info.mip;
         barrier.subresourceRange.levelCount = info.level == 0 ? info.image->mips : info.level;
         barrier.subresourceRange.baseArrayLayer = 0;
         barrier.subresourceRange.layerCount = 1;
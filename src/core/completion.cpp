@@ -0,0 +1,100 @@
+#include <corundum/core/completion.hpp>
+#include <corundum/core/context.hpp>
+
+#if defined(crd_enable_profiling)
+    #include <Tracy.hpp>
+#endif
+
+#include <ftl/wait_group.h>
+
+#include <algorithm>
+#include <chrono>
+
+namespace crd {
+    // Upper bound on how long the poller sleeps inside the driver before picking up newly watched tickets.
+    constexpr auto completion_poll_timeout = std::chrono::nanoseconds(std::chrono::milliseconds(1)).count();
+
+    static inline void poll_completions(CompletionService* service) noexcept {
+        crd_profile_scoped();
+        std::vector<CompletionService::Watch> watched;
+        std::vector<CompletionService::Watch> completed;
+        std::vector<VkSemaphore> semaphores;
+        std::vector<std::uint64_t> values;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> guard(service->lock);
+                crd_unlikely_if(watched.empty()) {
+                    service->wake.wait(guard, [service]() noexcept {
+                        return !service->running || !service->pending.empty();
+                    });
+                }
+                watched.insert(watched.end(), service->pending.begin(), service->pending.end());
+                service->pending.clear();
+                crd_unlikely_if(!service->running && watched.empty()) {
+                    return;
+                }
+            }
+            semaphores.clear();
+            values.clear();
+            for (const auto& each : watched) {
+                semaphores.emplace_back(each.timeline);
+                values.emplace_back(each.ticket);
+            }
+            VkSemaphoreWaitInfo wait_info;
+            wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+            wait_info.pNext = nullptr;
+            wait_info.flags = VK_SEMAPHORE_WAIT_ANY_BIT;
+            wait_info.semaphoreCount = semaphores.size();
+            wait_info.pSemaphores = semaphores.data();
+            wait_info.pValues = values.data();
+            vkWaitSemaphores(service->device, &wait_info, completion_poll_timeout);
+            completed.clear();
+            watched.erase(std::remove_if(watched.begin(), watched.end(), [&](const auto& each) noexcept {
+                std::uint64_t value;
+                crd_vulkan_check(vkGetSemaphoreCounterValue(service->device, each.timeline, &value));
+                crd_likely_if(value >= each.ticket) {
+                    completed.emplace_back(each);
+                    return true;
+                }
+                return false;
+            }), watched.end());
+            crd_likely_if(!completed.empty()) {
+                // Signaled under the service lock, see await_ticket.
+                std::lock_guard<std::mutex> guard(service->lock);
+                for (const auto& each : completed) {
+                    each.waiter->Done();
+                }
+            }
+        }
+    }
+
+    crd_nodiscard crd_module CompletionService* make_completion_service(const Context& context) noexcept {
+        crd_profile_scoped();
+        auto service = new CompletionService();
+        service->device = context.device;
+        service->running = true;
+        service->poller = std::thread(poll_completions, service);
+        return service;
+    }
+
+    crd_module void destroy_completion_service(CompletionService*& service) noexcept {
+        crd_profile_scoped();
+        {
+            std::lock_guard<std::mutex> guard(service->lock);
+            service->running = false;
+        }
+        service->wake.notify_one();
+        service->poller.join();
+        delete service;
+        service = nullptr;
+    }
+
+    crd_module void CompletionService::watch(VkSemaphore timeline, std::uint64_t ticket, ftl::WaitGroup* waiter) noexcept {
+        crd_profile_scoped();
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            pending.push_back({ timeline, ticket, waiter });
+        }
+        wake.notify_one();
+    }
+} // namespace crd
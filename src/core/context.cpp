@@ -1,6 +1,15 @@
+#include <corundum/core/descriptor_batcher.hpp>
+#include <corundum/core/texture_streamer.hpp>
+#include <corundum/core/geometry_arena.hpp>
+#include <corundum/core/upload_batcher.hpp>
+#include <corundum/core/file_reader.hpp>
+#include <corundum/core/staging_ring.hpp>
+#include <corundum/core/completion.hpp>
 #include <corundum/core/dispatch.hpp>
 #include <corundum/core/context.hpp>
 
+#include <corundum/detail/archive.hpp>
+
 #if defined(crd_enable_profiling)
     #include <Tracy.hpp>
 #endif
@@ -295,6 +304,8 @@ namespace crd {
             descriptor_indexing.descriptorBindingVariableDescriptorCount = true;
             descriptor_indexing.descriptorBindingPartiallyBound = true;
             descriptor_indexing.runtimeDescriptorArray = true;
+            descriptor_indexing.descriptorBindingSampledImageUpdateAfterBind = true;
+            descriptor_indexing.descriptorBindingUpdateUnusedWhilePending = true;
             VkDeviceCreateInfo device_info;
             device_info.pNext = nullptr;
             if (has_extension(extensions, VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME)) {
@@ -312,6 +323,16 @@ namespace crd {
                 context.extensions.buffer_address = true;
                 append_to_chain(device_info, buffer_address_features);
             }
+            if (has_extension(extensions, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME)) {
+                extension_names.emplace_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+                context.extensions.memory_budget = true;
+            } else {
+                spdlog::warn(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME" not available, heap budgets are estimated");
+            }
+            VkPhysicalDeviceTimelineSemaphoreFeatures timeline_features = {};
+            timeline_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+            timeline_features.timelineSemaphore = true;
+            append_to_chain(device_info, timeline_features);
 #if defined(crd_enable_raytracing)
             VkPhysicalDeviceAccelerationStructureFeaturesKHR acceleration_structure_features = {};
             acceleration_structure_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ACCELERATION_STRUCTURE_FEATURES_KHR;
@@ -362,6 +383,7 @@ namespace crd {
             (context.scheduler = new ftl::TaskScheduler())->Init({
                 .Behavior = ftl::EmptyQueueBehavior::Sleep
             });
+            context.completion = make_completion_service(context);
         }
         { // Creates a Descriptor Pool.
             const auto& limits = context.gpu.main_props.limits;
@@ -402,6 +424,9 @@ namespace crd {
             if (context.extensions.buffer_address) {
                 allocator_info.flags |= VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT;
             }
+            if (context.extensions.memory_budget) {
+                allocator_info.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+            }
             allocator_info.physicalDevice = context.gpu.handle;
             allocator_info.device = context.device;
             allocator_info.preferredLargeHeapBlockSize = 0;
@@ -414,6 +439,30 @@ namespace crd {
             allocator_info.pTypeExternalMemoryHandleTypes = nullptr;
             crd_vulkan_check(vmaCreateAllocator(&allocator_info, &context.allocator));
         }
+        { // Creates the upload staging ring.
+            spdlog::info("initializing staging ring");
+            context.staging = make_staging_ring(context);
+        }
+        { // Creates the upload batcher.
+            spdlog::info("initializing upload batcher");
+            context.uploads = make_upload_batcher(context);
+        }
+        { // Creates the descriptor write batcher.
+            spdlog::info("initializing descriptor batcher");
+            context.descriptors = make_descriptor_batcher(context);
+        }
+        { // Creates the file reader.
+            spdlog::info("initializing file reader");
+            context.reader = make_file_reader();
+        }
+        { // Creates the geometry arena.
+            spdlog::info("initializing geometry arena");
+            context.geometry = make_geometry_arena(context);
+        }
+        { // Creates the texture streamer.
+            spdlog::info("initializing texture streamer");
+            context.streamer = make_texture_streamer(context);
+        }
         spdlog::info("initializing dynamic dispatch");
         initialize_dynamic_dispatcher(context);
         spdlog::info("initialization completed");
@@ -423,11 +472,21 @@ namespace crd {
     crd_module void destroy_context(Context& context) noexcept {
         crd_profile_scoped();
         spdlog::info("terminating core context");
+        destroy_texture_streamer(context.streamer);
+        crd_unlikely_if(context.archive) {
+            dtl::destroy_archive(context.archive);
+        }
+        destroy_upload_batcher(context, context.uploads);
+        destroy_descriptor_batcher(context.descriptors);
+        destroy_file_reader(context.reader);
+        destroy_geometry_arena(context, context.geometry);
+        destroy_completion_service(context.completion);
         delete context.scheduler;
         destroy_queue(context, context.graphics);
         destroy_queue(context, context.transfer);
         destroy_queue(context, context.compute);
         vkDestroyDescriptorPool(context.device, context.descriptor_pool, nullptr);
+        destroy_staging_ring(context, context.staging);
         vmaDestroyAllocator(context.allocator);
         vkDestroyDevice(context.device, nullptr);
 #if defined(crd_debug)
@@ -443,4 +502,19 @@ namespace crd {
         crd_profile_scoped();
         return std::min<std::uint32_t>(context.gpu.main_props.limits.maxPerStageDescriptorSampledImages, 1024);
     }
+
+    crd_nodiscard crd_module bool mount_archive(Context& context, const char* path, const char* root) noexcept {
+        crd_profile_scoped();
+        auto archive = dtl::make_archive(path, root, context.scheduler);
+        crd_unlikely_if(!archive) {
+            spdlog::warn("archive \"{}\" could not be mounted, assets are read from \"{}\"", path, root);
+            return false;
+        }
+        crd_unlikely_if(context.archive) {
+            dtl::destroy_archive(context.archive);
+        }
+        context.archive = archive;
+        dtl::mount_archive(archive);
+        return true;
+    }
 } //namespace crd
@@ -0,0 +1,125 @@
+#include <corundum/core/descriptor_allocator.hpp>
+#include <corundum/core/descriptor_batcher.hpp>
+#include <corundum/core/pipeline.hpp>
+#include <corundum/core/context.hpp>
+#include <corundum/core/queue.hpp>
+
+#if defined(crd_enable_profiling)
+    #include <Tracy.hpp>
+#endif
+
+#include <spdlog/spdlog.h>
+
+#include <vulkan/vulkan.h>
+
+#include <array>
+
+namespace crd {
+    crd_nodiscard static inline VkDescriptorPool make_transient_pool(VkDevice device) noexcept {
+        crd_profile_scoped();
+        const auto descriptor_sizes = std::to_array<VkDescriptorPoolSize>({
+            { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,             transient_pool_sets * 2 },
+            { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,             transient_pool_sets * 2 },
+            { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,     transient_pool_sets * 4 },
+            { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,              transient_pool_sets     },
+#if defined(crd_enable_raytracing)
+            { VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR, transient_pool_sets     },
+#endif
+        });
+        VkDescriptorPoolCreateInfo pool_info;
+        pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        pool_info.pNext = nullptr;
+        pool_info.flags = {};
+        pool_info.maxSets = transient_pool_sets;
+        pool_info.poolSizeCount = descriptor_sizes.size();
+        pool_info.pPoolSizes = descriptor_sizes.data();
+        VkDescriptorPool pool;
+        crd_vulkan_check(vkCreateDescriptorPool(device, &pool_info, nullptr, &pool));
+        return pool;
+    }
+
+    crd_nodiscard crd_module VkDescriptorSet DescriptorAllocator::allocate(const DescriptorSetLayout& layout) noexcept {
+        crd_profile_scoped();
+        VkDescriptorSetAllocateInfo allocate_info;
+        allocate_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocate_info.pNext = nullptr;
+        allocate_info.descriptorSetCount = 1;
+        allocate_info.pSetLayouts = &layout.handle;
+        VkDescriptorSetVariableDescriptorCountAllocateInfo variable_count;
+        if (layout.dynamic) {
+            variable_count.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_VARIABLE_DESCRIPTOR_COUNT_ALLOCATE_INFO;
+            variable_count.pNext = nullptr;
+            variable_count.descriptorSetCount = 1;
+            variable_count.pDescriptorCounts = &layout.dyn_binds;
+            allocate_info.pNext = &variable_count;
+        }
+        std::lock_guard<std::mutex> guard(lock);
+        auto& chain = frames[frame];
+        chain.used = true;
+        VkDescriptorSet set;
+        while (true) {
+            const auto fresh = chain.current == chain.pools.size();
+            crd_unlikely_if(fresh) {
+                spdlog::info("descriptor pool chain of frame {} grown to {} pools", frame, chain.pools.size() + 1);
+                chain.pools.emplace_back(make_transient_pool(device));
+            }
+            allocate_info.descriptorPool = chain.pools[chain.current];
+            const auto result = vkAllocateDescriptorSets(device, &allocate_info, &set);
+            crd_likely_if(result == VK_SUCCESS) {
+                return set;
+            }
+            // Out of a fresh pool, the set can never fit in one.
+            crd_unlikely_if(fresh || (result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL)) {
+                crd_force_assert("transient descriptor set does not fit in a descriptor pool");
+            }
+            chain.current++;
+        }
+    }
+
+    crd_module void DescriptorAllocator::begin_frame(std::uint32_t index, std::uint64_t ticket) noexcept {
+        crd_profile_scoped();
+        // Decided under the lock, allocate() may be marking the chain used from another thread.
+        std::lock_guard<std::mutex> guard(lock);
+        frame = index;
+        auto& chain = frames[index];
+        crd_likely_if(!chain.used) {
+            return;
+        }
+        wait_ticket(*context, *context->graphics, ticket);
+        // Writes still recorded for the sets about to be recycled must go out first.
+        batcher->flush();
+        for (auto pool : chain.pools) {
+            crd_vulkan_check(vkResetDescriptorPool(device, pool, {}));
+        }
+        chain.current = 0;
+        chain.used = false;
+    }
+
+    crd_nodiscard crd_module DescriptorAllocator* make_descriptor_allocator(const Context& context) noexcept {
+        crd_profile_scoped();
+        auto allocator = new DescriptorAllocator();
+        allocator->context = &context;
+        allocator->device = context.device;
+        allocator->batcher = context.descriptors;
+        for (auto& chain : allocator->frames) {
+            chain.pools.emplace_back(make_transient_pool(context.device));
+            chain.current = 0;
+            chain.used = false;
+        }
+        allocator->frame = 0;
+        return allocator;
+    }
+
+    crd_module void destroy_descriptor_allocator(DescriptorAllocator*& allocator) noexcept {
+        crd_profile_scoped();
+        // Nothing may be left recorded for the sets freed along with the pools.
+        allocator->batcher->flush();
+        for (auto& chain : allocator->frames) {
+            for (auto pool : chain.pools) {
+                vkDestroyDescriptorPool(allocator->device, pool, nullptr);
+            }
+        }
+        delete allocator;
+        allocator = nullptr;
+    }
+} // namespace crd
@@ -0,0 +1,163 @@
+#include <corundum/core/descriptor_batcher.hpp>
+#include <corundum/core/pipeline.hpp>
+#include <corundum/core/context.hpp>
+
+#if defined(crd_enable_profiling)
+    #include <Tracy.hpp>
+#endif
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <vector>
+#include <atomic>
+#include <mutex>
+
+namespace crd {
+    // Tells batchers apart in the thread local arena cache, even when one is allocated where another was freed.
+    static std::atomic<std::uint64_t> batcher_ids = 1;
+
+    struct LocalArena {
+        std::uint64_t owner;
+        DescriptorBatcher::Arena* arena;
+    };
+
+    crd_nodiscard static inline DescriptorBatcher::Arena& local_arena(DescriptorBatcher& batcher) noexcept {
+        crd_profile_scoped();
+        thread_local LocalArena cached = {};
+        crd_likely_if(cached.owner == batcher.id) {
+            return *cached.arena;
+        }
+        std::lock_guard<std::mutex> guard(batcher.lock);
+        auto& arena = batcher.arenas[std::this_thread::get_id()];
+        crd_unlikely_if(!arena) {
+            arena = new DescriptorBatcher::Arena();
+        }
+        cached = { batcher.id, arena };
+        return *arena;
+    }
+
+    template <typename T>
+    static inline void record(DescriptorBatcher& batcher, std::vector<T> DescriptorBatcher::Arena::* payload, VkDescriptorSet set, const DescriptorBinding& binding, std::uint32_t first, const T* descriptors, std::uint32_t count) noexcept {
+        crd_profile_scoped();
+        auto& arena = local_arena(batcher);
+        {
+            std::lock_guard<std::mutex> guard(arena.lock);
+            auto& storage = arena.*payload;
+            auto& pending = arena.writes.emplace_back();
+            pending.write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            pending.write.pNext = nullptr;
+            pending.write.dstSet = set;
+            pending.write.dstBinding = binding.index;
+            pending.write.dstArrayElement = first;
+            pending.write.descriptorCount = count;
+            pending.write.descriptorType = binding.type;
+            pending.write.pImageInfo = nullptr;
+            pending.write.pBufferInfo = nullptr;
+            pending.write.pTexelBufferView = nullptr;
+            pending.first = storage.size();
+            storage.insert(storage.end(), descriptors, descriptors + count);
+        }
+        batcher.pending.fetch_add(1, std::memory_order_release);
+    }
+
+    crd_nodiscard static inline bool is_buffer(VkDescriptorType type) noexcept {
+        return type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER ||
+               type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER ||
+               type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC ||
+               type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    }
+
+    crd_module void DescriptorBatcher::write(VkDescriptorSet set, const DescriptorBinding& binding, std::uint32_t first, const VkDescriptorBufferInfo* buffers, std::uint32_t count) noexcept {
+        crd_profile_scoped();
+        record(*this, &Arena::buffers, set, binding, first, buffers, count);
+    }
+
+    crd_module void DescriptorBatcher::write(VkDescriptorSet set, const DescriptorBinding& binding, std::uint32_t first, const VkDescriptorImageInfo* images, std::uint32_t count) noexcept {
+        crd_profile_scoped();
+        record(*this, &Arena::images, set, binding, first, images, count);
+    }
+
+#if defined(crd_enable_raytracing)
+    crd_module void DescriptorBatcher::write(VkDescriptorSet set, const DescriptorBinding& binding, std::uint32_t first, const VkAccelerationStructureKHR* structures, std::uint32_t count) noexcept {
+        crd_profile_scoped();
+        record(*this, &Arena::structures, set, binding, first, structures, count);
+    }
+#endif
+
+    crd_module void DescriptorBatcher::flush() noexcept {
+        crd_profile_scoped();
+        crd_likely_if(pending.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+        std::lock_guard<std::mutex> guard(lock);
+        // Every arena stays locked until the update went through, the writes point into their payloads.
+        std::vector<std::unique_lock<std::mutex>> arena_guards;
+        arena_guards.reserve(arenas.size());
+        std::size_t recorded = 0;
+        for (auto& [_, arena] : arenas) {
+            arena_guards.emplace_back(arena->lock);
+            recorded += arena->writes.size();
+        }
+        crd_unlikely_if(recorded == 0) {
+            return;
+        }
+        writes.clear();
+        writes.reserve(recorded);
+#if defined(crd_enable_raytracing)
+        // Reserved up front, the writes keep pointers into it.
+        structure_writes.clear();
+        structure_writes.reserve(recorded);
+#endif
+        for (auto& [_, arena] : arenas) {
+            for (const auto& each : arena->writes) {
+                auto& update = writes.emplace_back(each.write);
+#if defined(crd_enable_raytracing)
+                crd_unlikely_if(update.descriptorType == VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR) {
+                    auto& structures = structure_writes.emplace_back();
+                    structures.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET_ACCELERATION_STRUCTURE_KHR;
+                    structures.pNext = nullptr;
+                    structures.accelerationStructureCount = update.descriptorCount;
+                    structures.pAccelerationStructures = arena->structures.data() + each.first;
+                    update.pNext = &structures;
+                    continue;
+                }
+#endif
+                crd_likely_if(is_buffer(update.descriptorType)) {
+                    update.pBufferInfo = arena->buffers.data() + each.first;
+                } else {
+                    update.pImageInfo = arena->images.data() + each.first;
+                }
+            }
+        }
+        vkUpdateDescriptorSets(device, writes.size(), writes.data(), 0, nullptr);
+        for (auto& [_, arena] : arenas) {
+            arena->writes.clear();
+            arena->buffers.clear();
+            arena->images.clear();
+#if defined(crd_enable_raytracing)
+            arena->structures.clear();
+#endif
+        }
+        pending.fetch_sub(recorded, std::memory_order_release);
+    }
+
+    crd_nodiscard crd_module DescriptorBatcher* make_descriptor_batcher(const Context& context) noexcept {
+        crd_profile_scoped();
+        auto batcher = new DescriptorBatcher();
+        batcher->device = context.device;
+        batcher->id = batcher_ids.fetch_add(1, std::memory_order_relaxed);
+        batcher->pending = 0;
+        return batcher;
+    }
+
+    crd_module void destroy_descriptor_batcher(DescriptorBatcher*& batcher) noexcept {
+        crd_profile_scoped();
+        // Whatever is still recorded targets sets freed along with the pool, there is nothing left to update.
+        for (auto& [_, arena] : batcher->arenas) {
+            delete arena;
+        }
+        delete batcher;
+        batcher = nullptr;
+    }
+} // namespace crd
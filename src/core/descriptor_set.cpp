@@ -1,22 +1,75 @@
 #include <corundum/core/acceleration_structure.hpp>
+#include <corundum/core/descriptor_allocator.hpp>
+#include <corundum/core/descriptor_batcher.hpp>
 #include <corundum/core/descriptor_set.hpp>
 #include <corundum/core/pipeline.hpp>
+#include <corundum/core/renderer.hpp>
 #include <corundum/core/context.hpp>
 #include <corundum/core/buffer.hpp>
 #include <corundum/core/image.hpp>
 
-#include <corundum/detail/hash.hpp>
-
 #include <spdlog/spdlog.h>
 
 #if defined(crd_enable_profiling)
     #include <Tracy.hpp>
 #endif
 
+#include <vector>
+
+#if defined(crd_log_descriptors)
+    #define crd_log_descriptor(...) spdlog::info(__VA_ARGS__)
+#else
+    #define crd_log_descriptor(...)
+#endif
+
 namespace crd {
+    crd_nodiscard static inline bool same(const VkDescriptorBufferInfo& lhs, const VkDescriptorBufferInfo& rhs) noexcept {
+        return lhs.buffer == rhs.buffer && lhs.offset == rhs.offset && lhs.range == rhs.range;
+    }
+
+    crd_nodiscard static inline bool same(const VkDescriptorImageInfo& lhs, const VkDescriptorImageInfo& rhs) noexcept {
+        return lhs.imageView == rhs.imageView && lhs.sampler == rhs.sampler && lhs.imageLayout == rhs.imageLayout;
+    }
+
+#if defined(crd_enable_raytracing)
+    crd_nodiscard static inline bool same(VkAccelerationStructureKHR lhs, VkAccelerationStructureKHR rhs) noexcept {
+        return lhs == rhs;
+    }
+#endif
+
+    crd_nodiscard static inline DescriptorSet<1>::Shadow& shadow(DescriptorSet<1>& set, const DescriptorBinding& binding) noexcept {
+        crd_unlikely_if(set.bound.size() <= binding.index) {
+            set.bound.resize(binding.index + 1);
+        }
+        return set.bound[binding.index];
+    }
+
+    // Compares `count` descriptors against the shadow of their binding starting at element `offset`, and calls
+    // emit(first, count) for every contiguous range that changed, after copying it into the shadow.
+    template <typename T, typename F>
+    static inline void diff_descriptors(std::vector<T>& shadow, std::uint32_t offset, const T* descriptors, std::size_t count, F&& emit) noexcept {
+        crd_profile_scoped();
+        crd_unlikely_if(shadow.size() < offset + count) {
+            shadow.resize(offset + count);
+        }
+        auto current = shadow.data() + offset;
+        for (std::size_t i = 0; i < count;) {
+            crd_likely_if(same(current[i], descriptors[i])) {
+                ++i;
+                continue;
+            }
+            const auto first = i;
+            for (; i < count && !same(current[i], descriptors[i]); ++i) {
+                current[i] = descriptors[i];
+            }
+            emit(offset + first, i - first);
+        }
+    }
+
     template <>
     crd_nodiscard crd_module DescriptorSet<1> make_descriptor_set(const Context& context, DescriptorSetLayout layout) noexcept {
         crd_profile_scoped();
+        crd_assert(!layout.bindless, "the bindless table is bound through BindlessTable, not allocated from");
         VkDescriptorSetAllocateInfo allocate_info;
         allocate_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
         allocate_info.pNext = nullptr;
@@ -33,7 +86,10 @@ namespace crd {
         }
         DescriptorSet<1> set;
         set.context = &context;
-        set.bound.reserve(128);
+        set.pool = context.descriptor_pool;
+        set.update_template = layout.update_template;
+        set.template_size = layout.template_size;
+        set.templated = layout.templated;
         crd_vulkan_check(vkAllocateDescriptorSets(context.device, &allocate_info, &set.handle));
         return set;
     }
@@ -48,141 +104,57 @@ namespace crd {
         return sets;
     }
 
+    crd_nodiscard crd_module DescriptorSet<1> make_transient_descriptor_set(Renderer& renderer, DescriptorSetLayout layout) noexcept {
+        crd_profile_scoped();
+        crd_assert(!layout.bindless, "the bindless table is bound through BindlessTable, not allocated from");
+        DescriptorSet<1> set;
+        set.context = renderer.context;
+        set.handle = renderer.descriptors->allocate(layout);
+        set.pool = nullptr;
+        set.update_template = layout.update_template;
+        set.template_size = layout.template_size;
+        set.templated = layout.templated;
+        return set;
+    }
+
     crd_module DescriptorSet<1>& DescriptorSet<1>::bind(const DescriptorBinding& binding, std::uint32_t offset, VkDescriptorBufferInfo buffer) noexcept {
         crd_profile_scoped();
-        const auto binding_hash = dtl::hash(0, binding);
-        const auto descriptor_hash = dtl::hash(0, buffer);
-        const auto is_bound =
-            std::find_if(bound.begin(), bound.end(), [=](const auto& each) {
-                return each.binding == binding_hash;
-            });
-        const auto found_binding = is_bound != bound.end();
-        crd_unlikely_if(!found_binding || is_bound->descriptor != descriptor_hash) {
-            spdlog::info("updating buffer descriptor with binding: {}, handle: {}, range: {}",
-                         binding.index, (const void*)buffer.buffer, buffer.range);
-            VkWriteDescriptorSet update;
-            update.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            update.pNext = nullptr;
-            update.dstSet = handle;
-            update.dstBinding = binding.index;
-            update.dstArrayElement = offset;
-            update.descriptorCount = 1;
-            update.descriptorType = binding.type;
-            update.pImageInfo = nullptr;
-            update.pBufferInfo = &buffer;
-            update.pTexelBufferView = nullptr;
-            vkUpdateDescriptorSets(context->device, 1, &update, 0, nullptr);
-            if (!found_binding) {
-                bound.push_back({ binding_hash, descriptor_hash });
-            } else {
-                is_bound->descriptor = descriptor_hash;
-            }
-        }
+        diff_descriptors(shadow(*this, binding).buffers, offset, &buffer, 1, [&](std::uint32_t, std::uint32_t) noexcept {
+            crd_log_descriptor("updating buffer descriptor with binding: {}, handle: {}, range: {}",
+                               binding.index, (const void*)buffer.buffer, buffer.range);
+            context->descriptors->write(handle, binding, offset, &buffer, 1);
+        });
         return *this;
     }
 
     crd_module DescriptorSet<1>& DescriptorSet<1>::bind(const DescriptorBinding& binding, std::uint32_t offset, VkDescriptorImageInfo image) noexcept {
         crd_profile_scoped();
-        const auto binding_hash = dtl::hash(0, binding);
-        const auto descriptor_hash = dtl::hash(0, image);
-        const auto is_bound =
-            std::find_if(bound.begin(), bound.end(), [=](const auto& each) {
-                return each.binding == binding_hash;
-            });
-        const auto found_binding = is_bound != bound.end();
-        crd_unlikely_if(!found_binding || is_bound->descriptor != descriptor_hash) {
-            spdlog::info("updating image descriptor with binding: {}, handle: {}",
-                         binding.index, (const void*)image.imageView);
-            VkWriteDescriptorSet update;
-            update.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            update.pNext = nullptr;
-            update.dstSet = handle;
-            update.dstBinding = binding.index;
-            update.dstArrayElement = offset;
-            update.descriptorCount = 1;
-            update.descriptorType = binding.type;
-            update.pImageInfo = &image;
-            update.pBufferInfo = nullptr;
-            update.pTexelBufferView = nullptr;
-            vkUpdateDescriptorSets(context->device, 1, &update, 0, nullptr);
-            crd_likely_if(found_binding) {
-                is_bound->descriptor = descriptor_hash;
-            } else {
-                bound.push_back({ binding_hash, descriptor_hash });
-            }
-        }
+        diff_descriptors(shadow(*this, binding).images, offset, &image, 1, [&](std::uint32_t, std::uint32_t) noexcept {
+            crd_log_descriptor("updating image descriptor with binding: {}, handle: {}",
+                               binding.index, (const void*)image.imageView);
+            context->descriptors->write(handle, binding, offset, &image, 1);
+        });
         return *this;
     }
 
 #if defined(crd_enable_raytracing)
     crd_module DescriptorSet<1>& DescriptorSet<1>::bind(const DescriptorBinding& binding, std::uint32_t offset, const AccelerationStructure& tlas) noexcept {
         crd_profile_scoped();
-        const auto binding_hash = dtl::hash(0, binding);
-        const auto descriptor_hash = dtl::hash(0, tlas);
-        const auto is_bound =
-            std::find_if(bound.begin(), bound.end(), [=](const auto& each) {
-                return each.binding == binding_hash;
-            });
-        const auto found_binding = is_bound != bound.end();
-        crd_unlikely_if(!found_binding || is_bound->descriptor != descriptor_hash) {
-            spdlog::info("updating TLAS descriptor with binding: {}, handle: {}",
-                         binding.index, (const void*)tlas.handle);
-            VkWriteDescriptorSetAccelerationStructureKHR as_update;
-            as_update.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET_ACCELERATION_STRUCTURE_KHR;
-            as_update.pNext = nullptr;
-            as_update.accelerationStructureCount = 1;
-            as_update.pAccelerationStructures = &tlas.handle;
-            VkWriteDescriptorSet update;
-            update.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            update.pNext = &as_update;
-            update.dstSet = handle;
-            update.dstBinding = binding.index;
-            update.dstArrayElement = offset;
-            update.descriptorCount = 1;
-            update.descriptorType = binding.type;
-            update.pImageInfo = nullptr;
-            update.pBufferInfo = nullptr;
-            update.pTexelBufferView = nullptr;
-            vkUpdateDescriptorSets(context->device, 1, &update, 0, nullptr);
-            if (found_binding) {
-                is_bound->descriptor = descriptor_hash;
-            } else {
-                bound.push_back({ binding_hash, descriptor_hash });
-            }
-        }
+        diff_descriptors(shadow(*this, binding).structures, offset, &tlas.handle, 1, [&](std::uint32_t, std::uint32_t) noexcept {
+            crd_log_descriptor("updating TLAS descriptor with binding: {}, handle: {}",
+                               binding.index, (const void*)tlas.handle);
+            context->descriptors->write(handle, binding, offset, &tlas.handle, 1);
+        });
         return *this;
     }
 #endif
 
     crd_module DescriptorSet<1>& DescriptorSet<1>::bind(const DescriptorBinding& binding, std::uint32_t offset, const std::vector<VkDescriptorImageInfo>& images) noexcept {
         crd_profile_scoped();
-        const auto binding_hash = dtl::hash(0, binding);
-        const auto descriptor_hash = dtl::hash(0, images);
-        const auto is_bound =
-            std::find_if(bound.begin(), bound.end(), [=](const auto& each) {
-                return each.binding == binding_hash;
-            });
-        const auto found_binding = is_bound != bound.end();
-        crd_unlikely_if(!found_binding || is_bound->descriptor != descriptor_hash) {
-            spdlog::info("updating image dynamic descriptor with binding: {}, images: {}", binding.index, images.size());
-            VkWriteDescriptorSet update;
-            update.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-            update.pNext = nullptr;
-            update.dstSet = handle;
-            update.dstBinding = binding.index;
-            update.dstArrayElement = offset;
-            update.descriptorCount = images.size();
-            update.descriptorType = binding.type;
-            update.pImageInfo = images.data();
-            update.pBufferInfo = nullptr;
-            update.pTexelBufferView = nullptr;
-            vkUpdateDescriptorSets(context->device, 1, &update, 0, nullptr);
-            if (found_binding) {
-                is_bound->descriptor = descriptor_hash;
-            } else {
-                bound.push_back({ binding_hash, descriptor_hash });
-            }
-        }
+        diff_descriptors(shadow(*this, binding).images, offset, images.data(), images.size(), [&](std::uint32_t first, std::uint32_t count) noexcept {
+            crd_log_descriptor("updating image dynamic descriptor with binding: {}, images: [{}, {})", binding.index, first, first + count);
+            context->descriptors->write(handle, binding, first, images.data() + (first - offset), count);
+        });
         return *this;
     }
 
@@ -208,9 +180,30 @@ namespace crd {
         return bind(binding, 0, images);
     }
 
+    crd_module DescriptorSet<1>& DescriptorSet<1>::update(const void* descriptors, std::size_t size) noexcept {
+        crd_profile_scoped();
+        crd_assert(update_template, "descriptor set has no update template");
+        crd_assert(size == template_size, "descriptor struct does not match the reflected set layout");
+        crd_log_descriptor("updating descriptor set through its template, bytes: {}", size);
+        // Writes recorded earlier must not land after this update and overwrite it.
+        context->descriptors->flush();
+        vkUpdateDescriptorSetWithTemplate(context->device, handle, update_template, descriptors);
+        // The shadows of the bindings written no longer tell what the set holds.
+        for (std::size_t i = 0; i < bound.size(); ++i) {
+            crd_likely_if(templated & (1ull << i)) {
+                bound[i] = {};
+            }
+        }
+        return *this;
+    }
+
     crd_module void DescriptorSet<1>::destroy() noexcept {
         crd_profile_scoped();
-        crd_vulkan_check(vkFreeDescriptorSets(context->device, context->descriptor_pool, 1, &handle));
+        // Writes still recorded for this set must not outlive it.
+        context->descriptors->flush();
+        crd_likely_if(pool) {
+            crd_vulkan_check(vkFreeDescriptorSets(context->device, pool, 1, &handle));
+        }
         *this = {};
     }
 
@@ -282,6 +275,14 @@ namespace crd {
         return *this;
     }
 
+    crd_module DescriptorSet<in_flight>& DescriptorSet<in_flight>::update(const void* descriptors, std::size_t size) noexcept {
+        crd_profile_scoped();
+        for (auto& each : handles) {
+            each.update(descriptors, size);
+        }
+        return *this;
+    }
+
     crd_nodiscard crd_module const DescriptorSet<1>& DescriptorSet<in_flight>::operator [](std::size_t index) const noexcept {
         crd_profile_scoped();
         return handles[index];
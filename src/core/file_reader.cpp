@@ -0,0 +1,305 @@
+#include <corundum/core/file_reader.hpp>
+#include <corundum/core/context.hpp>
+
+#include <corundum/detail/archive.hpp>
+
+#if defined(crd_enable_profiling)
+    #include <Tracy.hpp>
+#endif
+
+#if defined(_WIN32)
+    #include <Windows.h>
+#else
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #include <fcntl.h>
+#endif
+
+#include <spdlog/spdlog.h>
+
+#include <ftl/wait_group.h>
+
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <new>
+
+namespace crd {
+    // Completions moved out of the ring per wakeup.
+    constexpr auto io_completion_batch = 32u;
+
+    // Positional read on the calling thread, returns the bytes read or a negated error.
+    crd_nodiscard static inline std::int64_t read_at(const AsyncFile& file, void* dest, std::size_t size, std::size_t offset) noexcept {
+        crd_profile_scoped();
+#if defined(_WIN32)
+        OVERLAPPED overlapped = {};
+        overlapped.Offset = (DWORD)offset;
+        overlapped.OffsetHigh = (DWORD)(offset >> 32);
+        DWORD read = 0;
+        crd_unlikely_if(!ReadFile(file.handle, dest, (DWORD)size, &read, &overlapped)) {
+            return -(std::int64_t)GetLastError();
+        }
+        return read;
+#else
+        const auto result = pread(file.handle, dest, size, offset);
+        return result < 0 ? -errno : result;
+#endif
+    }
+
+    // Whether the request is complete, either fully read or failed. Otherwise moves it past the bytes read.
+    crd_nodiscard static inline bool advance(ReadRequest* request, std::int64_t result) noexcept {
+        crd_unlikely_if(result <= 0) {
+            crd_unlikely_if(result == -EAGAIN || result == -EINTR) {
+                return false;
+            }
+            spdlog::error("file read failed at offset {}: {}", request->offset + request->done, result < 0 ? std::strerror(-result) : "end of file");
+            request->failed = true;
+            return true;
+        }
+        request->done += result;
+        return request->done == request->size;
+    }
+
+    // Must hold the reader lock. Moves backlog requests into the ring while there is room.
+    static inline void submit_backlog(FileReader* reader) noexcept {
+        crd_profile_scoped();
+        while (!reader->backlog.empty() && reader->in_flight < reader->depth) {
+            auto request = reader->backlog.front();
+            crd_unlikely_if(!dtl::queue_read(
+                reader->ring,
+                request->file->handle,
+                request->dest + request->done,
+                request->size - request->done,
+                request->offset + request->done,
+                reinterpret_cast<std::uint64_t>(request))) {
+                break;
+            }
+            reader->backlog.pop_front();
+            ++reader->in_flight;
+        }
+        dtl::submit_io_ring(reader->ring);
+    }
+
+    static inline void complete_uring(FileReader* reader) noexcept {
+        crd_profile_scoped();
+        dtl::IoCompletion completions[io_completion_batch];
+        auto stopped = false;
+        while (true) {
+            const auto count = dtl::wait_io_ring(reader->ring, completions, io_completion_batch);
+            std::lock_guard<std::mutex> guard(reader->lock);
+            for (std::uint32_t i = 0; i < count; ++i) {
+                // The only user data of 0 is the wakeup posted by destroy_file_reader.
+                crd_unlikely_if(completions[i].user == 0) {
+                    stopped = true;
+                    continue;
+                }
+                auto request = reinterpret_cast<ReadRequest*>(completions[i].user);
+                --reader->in_flight;
+                crd_likely_if(advance(request, completions[i].result)) {
+                    // Signaled under the reader lock, see read_file.
+                    request->waiter->Done();
+                } else {
+                    reader->backlog.push_front(request);
+                }
+            }
+            submit_backlog(reader);
+            crd_unlikely_if(stopped && reader->in_flight == 0 && reader->backlog.empty()) {
+                return;
+            }
+        }
+    }
+
+    static inline void complete_positional(FileReader* reader) noexcept {
+        crd_profile_scoped();
+        while (true) {
+            ReadRequest* request;
+            {
+                std::unique_lock<std::mutex> guard(reader->lock);
+                reader->wake.wait(guard, [reader]() noexcept {
+                    return !reader->running || !reader->backlog.empty();
+                });
+                crd_unlikely_if(reader->backlog.empty()) {
+                    return;
+                }
+                request = reader->backlog.front();
+                reader->backlog.pop_front();
+            }
+            while (!advance(request, read_at(*request->file, request->dest + request->done, request->size - request->done, request->offset + request->done)));
+            std::lock_guard<std::mutex> guard(reader->lock);
+            request->waiter->Done();
+        }
+    }
+
+    crd_nodiscard crd_module FileReader* make_file_reader(std::uint32_t depth) noexcept {
+        crd_profile_scoped();
+        auto reader = new FileReader();
+        reader->uring = dtl::make_io_ring(reader->ring, depth);
+        reader->in_flight = 0;
+        reader->depth = reader->uring ? reader->ring.depth : depth;
+        reader->running = true;
+        crd_likely_if(reader->uring) {
+            spdlog::info("file reads go through io_uring, queue depth: {}", reader->depth);
+            reader->completer = std::thread(complete_uring, reader);
+        } else {
+            spdlog::info("io_uring is not available, file reads fall back to a dedicated thread");
+            reader->completer = std::thread(complete_positional, reader);
+        }
+        return reader;
+    }
+
+    crd_module void destroy_file_reader(FileReader*& reader) noexcept {
+        crd_profile_scoped();
+        {
+            std::lock_guard<std::mutex> guard(reader->lock);
+            reader->running = false;
+            crd_likely_if(reader->uring) {
+                // Completion order is not submission order, the completer drains every read before leaving.
+                while (!dtl::queue_nop(reader->ring, 0)) {
+                    dtl::submit_io_ring(reader->ring);
+                }
+                dtl::submit_io_ring(reader->ring);
+            }
+        }
+        reader->wake.notify_one();
+        reader->completer.join();
+        crd_likely_if(reader->uring) {
+            dtl::destroy_io_ring(reader->ring);
+        }
+        for (auto& buffer : reader->pool) {
+            operator delete[](buffer.data, std::align_val_t(io_alignment));
+        }
+        delete reader;
+        reader = nullptr;
+    }
+
+    crd_module void FileReader::enqueue(ReadRequest* request) noexcept {
+        crd_profile_scoped();
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            backlog.push_back(request);
+            crd_likely_if(uring) {
+                submit_backlog(this);
+            }
+        }
+        crd_unlikely_if(!uring) {
+            wake.notify_one();
+        }
+    }
+
+    crd_nodiscard crd_module ReadBuffer FileReader::acquire(std::size_t size) noexcept {
+        crd_profile_scoped();
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            // Smallest pooled buffer which fits.
+            auto best = pool.end();
+            for (auto it = pool.begin(); it != pool.end(); ++it) {
+                crd_likely_if(it->capacity >= size && (best == pool.end() || it->capacity < best->capacity)) {
+                    best = it;
+                }
+            }
+            crd_likely_if(best != pool.end()) {
+                const auto buffer = *best;
+                pool.erase(best);
+                return buffer;
+            }
+        }
+        ReadBuffer buffer;
+        buffer.capacity = (size + io_alignment - 1) & ~(io_alignment - 1);
+        buffer.data = static_cast<std::uint8_t*>(operator new[](buffer.capacity, std::align_val_t(io_alignment)));
+        return buffer;
+    }
+
+    crd_module void FileReader::release(ReadBuffer& buffer) noexcept {
+        crd_profile_scoped();
+        std::lock_guard<std::mutex> guard(lock);
+        pool.push_back(buffer);
+        buffer = {};
+    }
+
+    crd_nodiscard crd_module AsyncFile open_file(const char* path, FileAccess access) noexcept {
+        crd_profile_scoped();
+        AsyncFile file = {};
+        const auto archive = dtl::mounted_archive();
+        crd_unlikely_if(archive && dtl::find_entry(*archive, path)) {
+            file.view = dtl::make_file_view(path);
+            file.size = file.view.size;
+            return file;
+        }
+#if defined(_WIN32)
+        const auto flags = access == file_access_sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS;
+        file.handle = CreateFile(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | flags, nullptr);
+        crd_assert(file.handle != INVALID_HANDLE_VALUE, "file not found");
+        LARGE_INTEGER size;
+        GetFileSizeEx(file.handle, &size);
+        file.size = size.QuadPart;
+#else
+        file.handle = open(path, O_RDONLY | O_CLOEXEC);
+        crd_assert(file.handle != -1, "file not found");
+        struct stat file_info;
+        crd_assert(fstat(file.handle, &file_info) != -1, "failed to get file info");
+        file.size = file_info.st_size;
+    #if defined(POSIX_FADV_SEQUENTIAL)
+        posix_fadvise(file.handle, 0, 0, access == file_access_sequential ? POSIX_FADV_SEQUENTIAL : POSIX_FADV_RANDOM);
+    #endif
+#endif
+        return file;
+    }
+
+    crd_module void close_file(AsyncFile& file) noexcept {
+        crd_profile_scoped();
+        crd_unlikely_if(file.view.archived) {
+            dtl::destroy_file_view(file.view);
+            file = {};
+            return;
+        }
+#if defined(_WIN32)
+        CloseHandle(file.handle);
+#else
+        close(file.handle);
+#endif
+        file = {};
+    }
+
+    crd_nodiscard crd_module bool read_file(const Context& context, const AsyncFile& file, void* dest, std::size_t size, std::size_t offset) noexcept {
+        crd_profile_scoped();
+        crd_unlikely_if(size == 0) {
+            return true;
+        }
+        crd_unlikely_if(offset > file.size || size > file.size - offset) {
+            spdlog::error("read of {} bytes at {} is past the end of the file ({} bytes)", size, offset, file.size);
+            return false;
+        }
+        crd_unlikely_if(file.view.archived) {
+            std::memcpy(dest, static_cast<const std::uint8_t*>(file.view.data) + offset, size);
+            return true;
+        }
+        const auto chunks = (size + io_chunk_size - 1) / io_chunk_size;
+        std::vector<ReadRequest> requests(chunks);
+        ftl::WaitGroup waiter(context.scheduler);
+        waiter.Add(chunks);
+        for (std::size_t i = 0; i < chunks; ++i) {
+            auto& request = requests[i];
+            request.file = &file;
+            request.dest = static_cast<std::uint8_t*>(dest) + i * io_chunk_size;
+            request.size = std::min(io_chunk_size, size - i * io_chunk_size);
+            request.offset = offset + i * io_chunk_size;
+            request.done = 0;
+            request.waiter = &waiter;
+            request.failed = false;
+            context.reader->enqueue(&request);
+        }
+        waiter.Wait(true);
+        {
+            // The completer may still be inside Done() when we resume, it releases the lock only once it's out.
+            std::lock_guard<std::mutex> guard(context.reader->lock);
+        }
+        const auto failed = std::any_of(requests.begin(), requests.end(), [](const ReadRequest& request) noexcept {
+            return request.failed;
+        });
+        crd_unlikely_if(failed) {
+            spdlog::error("read of {} bytes at {} failed", size, offset);
+            return false;
+        }
+        return true;
+    }
+} // namespace crd
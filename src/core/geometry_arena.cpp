@@ -0,0 +1,259 @@
+#include <corundum/core/command_buffer.hpp>
+#include <corundum/core/geometry_arena.hpp>
+#include <corundum/core/utilities.hpp>
+#include <corundum/core/constants.hpp>
+#include <corundum/core/context.hpp>
+#include <corundum/core/queue.hpp>
+
+#if defined(crd_enable_profiling)
+    #include <Tracy.hpp>
+#endif
+
+#include <spdlog/spdlog.h>
+
+#include <ftl/task_scheduler.h>
+
+#include <algorithm>
+
+namespace crd {
+    crd_nodiscard static inline GeometryBlock* make_geometry_block(const Context& context, GeometryHeap& heap, std::size_t capacity) noexcept {
+        crd_profile_scoped();
+        spdlog::info("allocating geometry block, size: {} bytes", capacity);
+        auto block = new GeometryBlock();
+        block->heap = &heap;
+        block->buffer = make_static_buffer(context, {
+            .flags = heap.usage,
+            .usage = VMA_MEMORY_USAGE_GPU_ONLY,
+            .capacity = capacity,
+            .shared = true
+        });
+        block->free.push_back({ 0, capacity });
+        return block;
+    }
+
+    crd_nodiscard static inline bool allocate_from(GeometryBlock* block, GeometryRange& range) noexcept {
+        crd_profile_scoped();
+        for (auto it = block->free.begin(); it != block->free.end(); ++it) {
+            const auto start = align_up(it->offset, range.stride);
+            const auto end = it->offset + it->size;
+            crd_unlikely_if(start + range.size > end) {
+                continue;
+            }
+            const GeometryBlock::Free before = { it->offset, start - it->offset };
+            const GeometryBlock::Free after = { start + range.size, end - (start + range.size) };
+            it = block->free.erase(it);
+            crd_likely_if(after.size > 0) {
+                it = block->free.insert(it, after);
+            }
+            crd_unlikely_if(before.size > 0) {
+                block->free.insert(it, before);
+            }
+            range.block = block;
+            range.offset = start;
+            return true;
+        }
+        return false;
+    }
+
+    static inline void release_to(GeometryBlock* block, std::size_t offset, std::size_t size) noexcept {
+        crd_profile_scoped();
+        auto& holes = block->free;
+        const auto next = std::lower_bound(holes.begin(), holes.end(), offset, [](const auto& each, auto offset) noexcept {
+            return each.offset < offset;
+        });
+        auto it = holes.insert(next, { offset, size });
+        crd_likely_if(std::next(it) != holes.end() && it->offset + it->size == std::next(it)->offset) {
+            it->size += std::next(it)->size;
+            holes.erase(std::next(it));
+        }
+        crd_likely_if(it != holes.begin() && std::prev(it)->offset + std::prev(it)->size == it->offset) {
+            std::prev(it)->size += it->size;
+            holes.erase(it);
+        }
+    }
+
+    static inline void destroy_geometry_block(GeometryBlock* block) noexcept {
+        crd_profile_scoped();
+        block->buffer.destroy();
+        delete block;
+    }
+
+    crd_nodiscard static inline GeometryRange* allocate_range(const Context& context, GeometryHeap& heap, std::size_t size, std::uint32_t stride) noexcept {
+        crd_profile_scoped();
+        auto range = new GeometryRange();
+        range->size = size;
+        range->stride = stride;
+        for (const auto block : heap.blocks) {
+            crd_likely_if(allocate_from(block, *range)) {
+                heap.ranges.insert(range);
+                return range;
+            }
+        }
+        auto block = make_geometry_block(context, heap, std::max(heap.block_size, size));
+        heap.blocks.emplace_back(block);
+        crd_assert(allocate_from(block, *range), "fresh geometry block is too small");
+        heap.ranges.insert(range);
+        return range;
+    }
+
+    crd_nodiscard crd_module GeometryArena* make_geometry_arena(const Context&) noexcept {
+        crd_profile_scoped();
+        auto arena = new GeometryArena();
+        arena->defragmenting = false;
+        VkBufferUsageFlags usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+                                   VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+#if defined(crd_enable_raytracing)
+        usage |= VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR;
+#endif
+        arena->vertices.usage = usage | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+        arena->vertices.block_size = geometry_block_size;
+        arena->indices.usage = usage | VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+        arena->indices.block_size = geometry_block_size / 2;
+        return arena;
+    }
+
+    crd_module void destroy_geometry_arena(const Context& context, GeometryArena*& arena) noexcept {
+        crd_profile_scoped();
+        // The device is idle by now.
+        for (auto [block, _] : arena->retired) {
+            destroy_geometry_block(block);
+        }
+        for (auto* heap : { &arena->vertices, &arena->indices }) {
+            crd_assert(heap->ranges.empty(), "geometry arena destroyed while meshes are still alive");
+            for (auto block : heap->blocks) {
+                vmaDestroyBuffer(context.allocator, block->buffer.handle, block->buffer.allocation);
+                delete block;
+            }
+        }
+        delete arena;
+        arena = nullptr;
+    }
+
+    crd_nodiscard crd_module GeometryRange* GeometryArena::allocate_vertices(const Context& context, std::size_t size, std::uint32_t stride) noexcept {
+        crd_profile_scoped();
+        std::lock_guard<std::mutex> guard(lock);
+        return allocate_range(context, vertices, size, stride);
+    }
+
+    crd_nodiscard crd_module GeometryRange* GeometryArena::allocate_indices(const Context& context, std::size_t size, std::uint32_t stride) noexcept {
+        crd_profile_scoped();
+        std::lock_guard<std::mutex> guard(lock);
+        return allocate_range(context, indices, size, stride);
+    }
+
+    crd_module void GeometryArena::free(GeometryRange* range) noexcept {
+        crd_profile_scoped();
+        std::lock_guard<std::mutex> guard(lock);
+        // Freed while a defragmentation copies it, the spot reserved for it in the packed blocks goes back too.
+        crd_unlikely_if(defragmenting) {
+            const auto moved = moving.find(range);
+            crd_likely_if(moved != moving.end()) {
+                release_to(moved->second.block, moved->second.offset, moved->second.size);
+                moving.erase(moved);
+            }
+        }
+        release_to(range->block, range->offset, range->size);
+        range->block->heap->ranges.erase(range);
+        delete range;
+    }
+
+    crd_module void GeometryArena::defragment(const Context& context) noexcept {
+        crd_profile_scoped();
+        std::vector<GeometryBlock*> replaced;
+        std::vector<BufferCopy> copies;
+        {
+            // Only planning happens under the lock: the heaps switch to the packed blocks right away, so that
+            // allocations made while the copies run land there, the old blocks are only read by the copies.
+            std::lock_guard<std::mutex> guard(lock);
+            crd_unlikely_if(defragmenting) {
+                return;
+            }
+            defragmenting = true;
+            for (auto* heap : { &vertices, &indices }) {
+                std::vector<GeometryRange*> ranges(heap->ranges.begin(), heap->ranges.end());
+                std::sort(ranges.begin(), ranges.end(), [](const auto* lhs, const auto* rhs) noexcept {
+                    return lhs->size > rhs->size;
+                });
+                std::vector<GeometryBlock*> packed;
+                for (const auto range : ranges) {
+                    GeometryRange moved = *range;
+                    auto fits = false;
+                    for (const auto block : packed) {
+                        crd_likely_if(fits = allocate_from(block, moved)) {
+                            break;
+                        }
+                    }
+                    crd_unlikely_if(!fits) {
+                        packed.emplace_back(make_geometry_block(context, *heap, std::max(heap->block_size, range->size)));
+                        crd_assert(allocate_from(packed.back(), moved), "fresh geometry block is too small");
+                    }
+                    copies.push_back({
+                        .source = &range->block->buffer,
+                        .dest = &moved.block->buffer,
+                        .source_offset = range->offset,
+                        .dest_offset = moved.offset,
+                        .size = range->size
+                    });
+                    moving.emplace(range, moved);
+                }
+                replaced.insert(replaced.end(), heap->blocks.begin(), heap->blocks.end());
+                spdlog::info("defragmenting geometry heap, blocks: {} -> {}", heap->blocks.size(), packed.size());
+                heap->blocks = std::move(packed);
+            }
+        }
+
+        // The fiber is suspended until the copies complete, the arena must not be locked meanwhile:
+        // another fiber of this thread taking it would block the very thread this fiber resumes on.
+        const auto thread_index = context.scheduler->GetCurrentThreadIndex();
+        auto commands = make_command_buffer(context, {
+            .pool = context.graphics->transient[thread_index],
+            .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY
+        });
+        commands.begin();
+        for (const auto& copy : copies) {
+            commands.copy_buffer(copy);
+        }
+        commands
+            .memory_barrier({
+                .source_stage = VK_PIPELINE_STAGE_TRANSFER_BIT,
+                .dest_stage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                .source_access = VK_ACCESS_TRANSFER_WRITE_BIT,
+                .dest_access = VK_ACCESS_MEMORY_READ_BIT
+            })
+            .end();
+        immediate_submit(context, commands, queue_type_graphics);
+        destroy_command_buffer(context, commands);
+
+        std::lock_guard<std::mutex> guard(lock);
+        // Ranges freed in the meantime already left `moving`.
+        for (auto& [range, moved] : moving) {
+            *range = moved;
+        }
+        moving.clear();
+        // Anything submitted up to now may still read the old blocks, frames in flight included.
+        std::uint64_t ticket;
+        {
+            std::lock_guard<std::mutex> queue_guard(context.graphics->lock);
+            ticket = context.graphics->ticket;
+        }
+        for (auto block : replaced) {
+            retired.push_back({ block, ticket });
+        }
+        defragmenting = false;
+    }
+
+    crd_module void GeometryArena::collect(const Context& context) noexcept {
+        crd_profile_scoped();
+        std::lock_guard<std::mutex> guard(lock);
+        crd_likely_if(retired.empty()) {
+            return;
+        }
+        std::erase_if(retired, [&context](const Retired& each) noexcept {
+            crd_unlikely_if(is_complete(context, *context.graphics, each.ticket)) {
+                destroy_geometry_block(each.block);
+                return true;
+            }
+            return false;
+        });
+    }
+} // namespace crd
@@ -3,6 +3,7 @@
 #include <corundum/core/pipeline.hpp>
 #include <corundum/core/renderer.hpp>
 #include <corundum/core/dispatch.hpp>
+#include <corundum/core/bindless.hpp>
 #include <corundum/core/context.hpp>
 
 #include <corundum/detail/file_view.hpp>
@@ -30,6 +31,101 @@ namespace crd {
         return (size + alignment - 1) & ~(alignment - 1);
     }
 
+    crd_nodiscard static inline std::uint32_t attribute_size(VertexAttribute attribute) noexcept {
+        crd_profile_scoped();
+        switch (attribute) {
+            case vertex_attribute_vec1:      return sizeof(float[1]);
+            case vertex_attribute_vec2:      return sizeof(float[2]);
+            case vertex_attribute_vec3:      return sizeof(float[3]);
+            case vertex_attribute_vec4:      return sizeof(float[4]);
+            case vertex_attribute_half2:     return sizeof(std::uint16_t[2]);
+            case vertex_attribute_snorm16x2: return sizeof(std::int16_t[2]);
+            case vertex_attribute_snorm8x4:  return sizeof(std::int8_t[4]);
+        }
+        crd_unreachable();
+    }
+
+    // Only the set the pipeline opted in with is the renderer's bindless table.
+    crd_nodiscard static inline bool is_bindless_set(const Renderer& renderer, std::uint32_t bindless_set, std::size_t index, const std::vector<DescriptorBinding>& descriptors) noexcept {
+        crd_profile_scoped();
+        crd_likely_if(index != bindless_set) {
+            return false;
+        }
+        crd_assert(renderer.bindless, "bindless set requested without a bindless table");
+        crd_assert(
+            descriptors.size() == 1 &&
+            descriptors[0].dynamic &&
+            descriptors[0].index == 0 &&
+            descriptors[0].type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+            "bindless set must hold nothing but an unsized sampler array at binding 0");
+        return renderer.bindless != nullptr;
+    }
+
+    // Lays the descriptors of every sized binding out back to back in binding order, one VkDescriptorBufferInfo,
+    // VkDescriptorImageInfo or VkAccelerationStructureKHR per element, and builds the template writing them.
+    // Unsized arrays are left out, their length is only known once bound.
+    static inline void make_update_template(Renderer& renderer, std::size_t layout_hash, std::vector<DescriptorBinding> descriptors, DescriptorSetLayout& layout) noexcept {
+        crd_profile_scoped();
+        std::sort(descriptors.begin(), descriptors.end(), [](const auto& lhs, const auto& rhs) noexcept {
+            return lhs.index < rhs.index;
+        });
+        std::vector<VkDescriptorUpdateTemplateEntry> entries;
+        entries.reserve(descriptors.size());
+        std::size_t offset = 0;
+        for (const auto& binding : descriptors) {
+            crd_unlikely_if(binding.dynamic) {
+                continue;
+            }
+            crd_assert(binding.index < 64, "binding index too large for an update template");
+            std::size_t stride = sizeof(VkDescriptorImageInfo);
+            switch (binding.type) {
+                case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+                case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+                case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
+                case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
+                    stride = sizeof(VkDescriptorBufferInfo);
+                    break;
+#if defined(crd_enable_raytracing)
+                case VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR:
+                    stride = sizeof(VkAccelerationStructureKHR);
+                    break;
+#endif
+                default: break;
+            }
+            entries.push_back({
+                .dstBinding = binding.index,
+                .dstArrayElement = 0,
+                .descriptorCount = binding.count,
+                .descriptorType = binding.type,
+                .offset = offset,
+                .stride = stride
+            });
+            offset += stride * binding.count;
+            layout.templated |= 1ull << binding.index;
+        }
+        crd_unlikely_if(entries.empty()) {
+            return;
+        }
+        layout.template_size = offset;
+        auto& update_template = renderer.set_template_cache[layout_hash];
+        crd_unlikely_if(!update_template) {
+            VkDescriptorUpdateTemplateCreateInfo template_info;
+            template_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO;
+            template_info.pNext = nullptr;
+            template_info.flags = {};
+            template_info.descriptorUpdateEntryCount = entries.size();
+            template_info.pDescriptorUpdateEntries = entries.data();
+            template_info.templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET;
+            template_info.descriptorSetLayout = layout.handle;
+            // Only used by push descriptor templates.
+            template_info.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+            template_info.pipelineLayout = nullptr;
+            template_info.set = 0;
+            crd_vulkan_check(vkCreateDescriptorUpdateTemplate(renderer.context->device, &template_info, nullptr, &update_template));
+        }
+        layout.update_template = update_template;
+    }
+
     crd_nodiscard static inline std::vector<std::uint32_t> import_spirv(const char* path) noexcept {
         crd_profile_scoped();
         auto file = dtl::make_file_view(path);
@@ -339,7 +435,7 @@ namespace crd {
         vertex_binding_description.stride =
             std::accumulate(info.attributes.begin(), info.attributes.end(), 0u,
                 [](const auto value, const auto attribute) noexcept {
-                    return value + static_cast<std::underlying_type_t<VertexAttribute>>(attribute);
+                    return value + attribute_size(attribute);
                 });
         vertex_binding_description.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
 
@@ -351,16 +447,19 @@ namespace crd {
                 .binding = 0,
                 .format = [&]() noexcept {
                     switch (attribute) {
-                        case vertex_attribute_vec1: return VK_FORMAT_R32_SFLOAT;
-                        case vertex_attribute_vec2: return VK_FORMAT_R32G32_SFLOAT;
-                        case vertex_attribute_vec3: return VK_FORMAT_R32G32B32_SFLOAT;
-                        case vertex_attribute_vec4: return VK_FORMAT_R32G32B32A32_SFLOAT;
+                        case vertex_attribute_vec1:      return VK_FORMAT_R32_SFLOAT;
+                        case vertex_attribute_vec2:      return VK_FORMAT_R32G32_SFLOAT;
+                        case vertex_attribute_vec3:      return VK_FORMAT_R32G32B32_SFLOAT;
+                        case vertex_attribute_vec4:      return VK_FORMAT_R32G32B32A32_SFLOAT;
+                        case vertex_attribute_half2:     return VK_FORMAT_R16G16_SFLOAT;
+                        case vertex_attribute_snorm16x2: return VK_FORMAT_R16G16_SNORM;
+                        case vertex_attribute_snorm8x4:  return VK_FORMAT_R8G8B8A8_SNORM;
                     }
                     crd_unreachable();
                 }(),
                 .offset = offset
             });
-            offset += static_cast<std::underlying_type_t<VertexAttribute>>(attribute);
+            offset += attribute_size(attribute);
         }
 
         VkPipelineVertexInputStateCreateInfo vertex_input_state = {};
@@ -458,6 +557,11 @@ namespace crd {
         std::vector<VkDescriptorSetLayout> set_layout_handles;
         set_layout_handles.reserve(pipeline_descriptor_layout.size());
         for (const auto& [index, descriptors] : pipeline_descriptor_layout) {
+            crd_unlikely_if(is_bindless_set(renderer, info.bindless_set, index, descriptors)) {
+                set_layouts.push_back({ renderer.bindless->layout, 0, false, nullptr, 0, 0, true });
+                set_layout_handles.emplace_back(renderer.bindless->layout);
+                continue;
+            }
             bool dynamic = false;
             std::uint32_t max_bindings = 0;
             const auto layout_hash = dtl::hash(0, descriptors);
@@ -499,7 +603,9 @@ namespace crd {
                 layout_info.pBindings = bindings.data();
                 crd_vulkan_check(vkCreateDescriptorSetLayout(context->device, &layout_info, nullptr, &layout));
             }
-            set_layouts.push_back({ layout, max_bindings, dynamic });
+            DescriptorSetLayout set_layout = { layout, max_bindings, dynamic };
+            make_update_template(renderer, layout_hash, descriptors, set_layout);
+            set_layouts.push_back(set_layout);
             set_layout_handles.emplace_back(layout);
         }
         pipeline.type = Pipeline::type_graphics;
@@ -634,6 +740,11 @@ namespace crd {
         std::vector<VkDescriptorSetLayout> set_layout_handles;
         set_layout_handles.reserve(pipeline_descriptor_layout.size());
         for (const auto& [index, descriptors] : pipeline_descriptor_layout) {
+            crd_unlikely_if(is_bindless_set(renderer, info.bindless_set, index, descriptors)) {
+                set_layouts.push_back({ renderer.bindless->layout, 0, false, nullptr, 0, 0, true });
+                set_layout_handles.emplace_back(renderer.bindless->layout);
+                continue;
+            }
             bool dynamic = false;
             std::uint32_t max_bindings = 0;
             const auto layout_hash = dtl::hash(0, descriptors);
@@ -678,7 +789,9 @@ namespace crd {
                 layout_info.pBindings = bindings.data();
                 crd_vulkan_check(vkCreateDescriptorSetLayout(context->device, &layout_info, nullptr, &layout));
             }
-            set_layouts.push_back({ layout, max_bindings, dynamic });
+            DescriptorSetLayout set_layout = { layout, max_bindings, dynamic };
+            make_update_template(renderer, layout_hash, descriptors, set_layout);
+            set_layouts.push_back(set_layout);
             set_layout_handles.emplace_back(layout);
         }
         pipeline.type = Pipeline::type_compute;
@@ -960,6 +1073,11 @@ namespace crd {
         std::vector<VkDescriptorSetLayout> set_layout_handles;
         set_layout_handles.reserve(pipeline_descriptor_layout.size());
         for (const auto& [index, descriptors] : pipeline_descriptor_layout) {
+            crd_unlikely_if(is_bindless_set(renderer, info.bindless_set, index, descriptors)) {
+                set_layouts.push_back({ renderer.bindless->layout, 0, false, nullptr, 0, 0, true });
+                set_layout_handles.emplace_back(renderer.bindless->layout);
+                continue;
+            }
             bool dynamic = false;
             std::uint32_t max_bindings = 0;
             const auto layout_hash = dtl::hash(0, descriptors);
@@ -1004,7 +1122,9 @@ namespace crd {
                 layout_info.pBindings = bindings.data();
                 crd_vulkan_check(vkCreateDescriptorSetLayout(context->device, &layout_info, nullptr, &layout));
             }
-            set_layouts.push_back({ layout, max_bindings, dynamic });
+            DescriptorSetLayout set_layout = { layout, max_bindings, dynamic };
+            make_update_template(renderer, layout_hash, descriptors, set_layout);
+            set_layouts.push_back(set_layout);
             set_layout_handles.emplace_back(layout);
         }
         pipeline.type = Pipeline::type_raytracing;
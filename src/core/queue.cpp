@@ -1,5 +1,6 @@
 
 #include <corundum/core/command_buffer.hpp>
+#include <corundum/core/completion.hpp>
 #include <corundum/core/swapchain.hpp>
 #include <corundum/core/context.hpp>
 #include <corundum/core/queue.hpp>
@@ -8,6 +9,8 @@
     #include <Tracy.hpp>
 #endif
 
+#include <ftl/wait_group.h>
+
 #include <thread>
 
 namespace crd {
@@ -27,6 +30,17 @@ namespace crd {
         for (int i = 0; i < threads; ++i) {
             crd_vulkan_check(vkCreateCommandPool(context.device, &command_pool_info, nullptr, &queue->transient.emplace_back()));
         }
+        VkSemaphoreTypeCreateInfo timeline_info;
+        timeline_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+        timeline_info.pNext = nullptr;
+        timeline_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        timeline_info.initialValue = 0;
+        VkSemaphoreCreateInfo semaphore_info;
+        semaphore_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        semaphore_info.pNext = &timeline_info;
+        semaphore_info.flags = {};
+        crd_vulkan_check(vkCreateSemaphore(context.device, &semaphore_info, nullptr, &queue->timeline));
+        queue->ticket = 0;
         vkGetDeviceQueue(context.device, queue->family, family.index, &queue->handle);
         return queue;
     }
@@ -37,25 +51,52 @@ namespace crd {
             vkDestroyCommandPool(context.device, pool, nullptr);
         }
         vkDestroyCommandPool(context.device, queue->pool, nullptr);
+        vkDestroySemaphore(context.device, queue->timeline, nullptr);
         delete queue;
         queue = nullptr;
     }
 
-    crd_module void Queue::submit(const SubmitInfo& submit) noexcept {
+    crd_module std::uint64_t Queue::submit(const SubmitInfo& submit) noexcept {
         crd_profile_scoped();
+        // Binary semaphores ignore their value, the timeline ones are appended after them.
+        auto waits = submit.waits;
+        auto stages = submit.stages;
+        std::vector<std::uint64_t> wait_values(waits.size());
+        waits.reserve(waits.size() + submit.tickets.size());
+        stages.reserve(stages.size() + submit.tickets.size());
+        wait_values.reserve(waits.size() + submit.tickets.size());
+        for (const auto& [queue, ticket, stage] : submit.tickets) {
+            waits.emplace_back(queue->timeline);
+            stages.emplace_back(stage);
+            wait_values.emplace_back(ticket);
+        }
+        auto signals = submit.signals;
+        signals.emplace_back(timeline);
+        std::vector<std::uint64_t> signal_values(signals.size());
+
+        VkTimelineSemaphoreSubmitInfo timeline_info;
+        timeline_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        timeline_info.pNext = nullptr;
+        timeline_info.waitSemaphoreValueCount = wait_values.size();
+        timeline_info.pWaitSemaphoreValues = wait_values.data();
+        timeline_info.signalSemaphoreValueCount = signal_values.size();
+        timeline_info.pSignalSemaphoreValues = signal_values.data();
+
         VkSubmitInfo submit_info;
         submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        submit_info.pNext = nullptr;
-        submit_info.waitSemaphoreCount = submit.waits.size();
-        submit_info.pWaitSemaphores = submit.waits.data();
-        submit_info.pWaitDstStageMask = submit.stages.data();
+        submit_info.pNext = &timeline_info;
+        submit_info.waitSemaphoreCount = waits.size();
+        submit_info.pWaitSemaphores = waits.data();
+        submit_info.pWaitDstStageMask = stages.data();
         submit_info.commandBufferCount = 1;
         submit_info.pCommandBuffers = &submit.commands.handle;
-        submit_info.signalSemaphoreCount = submit.signals.size();
-        submit_info.pSignalSemaphores = submit.signals.data();
+        submit_info.signalSemaphoreCount = signals.size();
+        submit_info.pSignalSemaphores = signals.data();
 
         std::lock_guard<std::mutex> guard(lock);
-        crd_vulkan_check(vkQueueSubmit(handle, 1, &submit_info, submit.done));
+        signal_values.back() = ++ticket;
+        crd_vulkan_check(vkQueueSubmit(handle, 1, &submit_info, nullptr));
+        return ticket;
     }
 
     crd_module VkResult Queue::present(const Swapchain& swapchain, std::uint32_t image, std::vector<VkSemaphore>&& wait) noexcept {
@@ -80,19 +121,42 @@ namespace crd {
         crd_vulkan_check(vkQueueWaitIdle(handle));
     }
 
-    crd_module void wait_fence(const Context& context, VkFence fence) noexcept {
+    crd_nodiscard crd_module bool is_complete(const Context& context, const Queue& queue, std::uint64_t ticket) noexcept {
         crd_profile_scoped();
-        crd_vulkan_check(vkWaitForFences(context.device, 1, &fence, true, -1));
+        std::uint64_t value;
+        crd_vulkan_check(vkGetSemaphoreCounterValue(context.device, queue.timeline, &value));
+        return value >= ticket;
+    }
+
+    crd_module void wait_ticket(const Context& context, const Queue& queue, std::uint64_t ticket) noexcept {
+        crd_profile_scoped();
+        VkSemaphoreWaitInfo wait_info;
+        wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+        wait_info.pNext = nullptr;
+        wait_info.flags = {};
+        wait_info.semaphoreCount = 1;
+        wait_info.pSemaphores = &queue.timeline;
+        wait_info.pValues = &ticket;
+        crd_vulkan_check(vkWaitSemaphores(context.device, &wait_info, -1));
+    }
+
+    crd_module void await_ticket(const Context& context, const Queue& queue, std::uint64_t ticket) noexcept {
+        crd_profile_scoped();
+        crd_likely_if(is_complete(context, queue, ticket)) {
+            return;
+        }
+        ftl::WaitGroup waiter(context.scheduler);
+        waiter.Add(1);
+        context.completion->watch(queue.timeline, ticket, &waiter);
+        // Pinned: the calling task keeps using the transient pools of the thread it started on,
+        // and resuming a pinned fiber is what makes it safe for the poller thread to call Done().
+        waiter.Wait(true);
+        // The poller may still be inside Done() when we resume, it releases the lock only once it's out.
+        std::lock_guard<std::mutex> guard(context.completion->lock);
     }
 
     crd_module void immediate_submit(const Context& context, const CommandBuffer& commands, QueueType type) noexcept {
         crd_profile_scoped();
-        VkFenceCreateInfo fence_info;
-        fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-        fence_info.pNext = nullptr;
-        fence_info.flags = {};
-        VkFence fence;
-        crd_vulkan_check(vkCreateFence(context.device, &fence_info, nullptr, &fence));
         Queue* queue;
         switch (type) {
             case queue_type_graphics: queue = context.graphics; break;
@@ -100,14 +164,13 @@ namespace crd {
             case queue_type_compute:  queue = context.compute;  break;
             default: crd_unreachable();
         }
-        queue->submit({
+        const auto ticket = queue->submit({
             .commands = commands,
             .stages = {},
             .waits = {},
             .signals = {},
-            .done = fence
+            .tickets = {}
         });
-        wait_fence(context, fence);
-        vkDestroyFence(context.device, fence, nullptr);
+        await_ticket(context, *queue, ticket);
     }
 } // namespace crd
@@ -1,4 +1,9 @@
+#include <corundum/core/descriptor_allocator.hpp>
+#include <corundum/core/texture_registry.hpp>
+#include <corundum/core/texture_streamer.hpp>
+#include <corundum/core/geometry_arena.hpp>
 #include <corundum/core/swapchain.hpp>
+#include <corundum/core/bindless.hpp>
 #include <corundum/core/renderer.hpp>
 #include <corundum/core/context.hpp>
 #include <corundum/core/image.hpp>
@@ -23,13 +28,8 @@ namespace crd {
         for (std::size_t i = 0; i < in_flight; ++i) {
             vkDestroySemaphore(context->device, renderer.img_ready[i], nullptr);
             vkDestroySemaphore(context->device, renderer.gfx_done[i], nullptr);
-            vkDestroyFence(context->device, renderer.cmd_wait[i], nullptr);
         }
 
-        VkFenceCreateInfo fence_info;
-        fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-        fence_info.pNext = nullptr;
-        fence_info.flags = VK_FENCE_CREATE_SIGNALED_BIT;
         VkSemaphoreCreateInfo semaphore_info;
         semaphore_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
         semaphore_info.pNext = nullptr;
@@ -37,7 +37,6 @@ namespace crd {
         for (std::size_t i = 0; i < in_flight; ++i) {
             crd_vulkan_check(vkCreateSemaphore(context->device, &semaphore_info, nullptr, &renderer.img_ready[i]));
             crd_vulkan_check(vkCreateSemaphore(context->device, &semaphore_info, nullptr, &renderer.gfx_done[i]));
-            crd_vulkan_check(vkCreateFence(context->device, &fence_info, nullptr, &renderer.cmd_wait[i]));
         }
     }
 
@@ -54,17 +53,20 @@ namespace crd {
         renderer.context = &context;
         renderer.frame_idx = 0;
         renderer.image_idx = 0;
+        renderer.textures = make_texture_registry();
+        renderer.descriptors = make_descriptor_allocator(context);
+        renderer.bindless = nullptr;
+        crd_likely_if(context.extensions.descriptor_indexing) {
+            renderer.bindless = make_bindless_table(context);
+        } else {
+            spdlog::warn("bindless texture table not available");
+        }
         renderer.gfx_cmds = make_command_buffers(context, {
             .count = in_flight,
             .pool = context.graphics->pool,
             .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY
         });
 
-        VkFenceCreateInfo fence_info;
-        fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-        fence_info.pNext = nullptr;
-        fence_info.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-
         VkSemaphoreCreateInfo semaphore_info;
         semaphore_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
         semaphore_info.pNext = nullptr;
@@ -73,7 +75,7 @@ namespace crd {
         for (std::size_t i = 0; i < in_flight; ++i) {
             crd_vulkan_check(vkCreateSemaphore(context.device, &semaphore_info, nullptr, &renderer.img_ready[i]));
             crd_vulkan_check(vkCreateSemaphore(context.device, &semaphore_info, nullptr, &renderer.gfx_done[i]));
-            crd_vulkan_check(vkCreateFence(context.device, &fence_info, nullptr, &renderer.cmd_wait[i]));
+            renderer.frame_ticket[i] = 0;
         }
         return renderer;
     }
@@ -85,27 +87,34 @@ namespace crd {
             sync_renderer(*this);
             recreate_swapchain(*context, window, swapchain);
         }
+        context->streamer->begin_frame();
+        context->geometry->collect(*context);
+        // The transient sets and the bindless copy of this frame are recycled once its previous submission is done with them.
+        descriptors->begin_frame(frame_idx, frame_ticket[frame_idx]);
+        crd_likely_if(bindless) {
+            wait_ticket(*context, *context->graphics, frame_ticket[frame_idx]);
+            bindless->begin_frame(frame_idx);
+        }
         return {
             .commands = gfx_cmds[frame_idx],
             .image = swapchain.images[image_idx],
             .index = frame_idx,
             .wait = img_ready[frame_idx],
             .signal = gfx_done[frame_idx],
-            .done = cmd_wait[frame_idx],
+            .done = frame_ticket[frame_idx],
         };
     }
 
     crd_module void Renderer::present_frame(PresentInfo&& info) noexcept {
         crd_profile_scoped();
         auto [commands, window, swapchain, waits, stages] = info;
-        crd_vulkan_check(vkResetFences(context->device, 1, &cmd_wait[frame_idx]));
         waits.emplace_back(img_ready[frame_idx]);
-        context->graphics->submit({
+        frame_ticket[frame_idx] = context->graphics->submit({
             .commands = commands,
             .stages = stages,
             .waits = std::move(waits),
             .signals = { gfx_done[frame_idx] },
-            .done = cmd_wait[frame_idx]
+            .tickets = {}
         });
         const auto result = context->graphics->present(swapchain, image_idx, { gfx_done[frame_idx] });
         crd_unlikely_if(result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
@@ -149,7 +158,14 @@ namespace crd {
         for (std::size_t i = 0; i < in_flight; ++i) {
             vkDestroySemaphore(context->device, img_ready[i], nullptr);
             vkDestroySemaphore(context->device, gfx_done[i], nullptr);
-            vkDestroyFence(context->device, cmd_wait[i], nullptr);
+        }
+        destroy_texture_registry(textures);
+        destroy_descriptor_allocator(descriptors);
+        crd_likely_if(bindless) {
+            destroy_bindless_table(bindless);
+        }
+        for (const auto [_, update_template] : set_template_cache) {
+            vkDestroyDescriptorUpdateTemplate(context->device, update_template, nullptr);
         }
         for (const auto [_, layout] : set_layout_cache) {
             vkDestroyDescriptorSetLayout(context->device, layout, nullptr);
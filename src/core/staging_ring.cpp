@@ -0,0 +1,92 @@
+#include <corundum/core/staging_ring.hpp>
+#include <corundum/core/utilities.hpp>
+#include <corundum/core/context.hpp>
+
+#if defined(crd_enable_profiling)
+    #include <Tracy.hpp>
+#endif
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+
+namespace crd {
+    crd_nodiscard crd_module StagingRing* make_staging_ring(const Context& context, std::size_t capacity) noexcept {
+        crd_profile_scoped();
+        auto ring = new StagingRing();
+        ring->buffer = make_static_buffer(context, {
+            .flags = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            .usage = VMA_MEMORY_USAGE_CPU_ONLY,
+            .capacity = capacity
+        });
+        ring->head = 0;
+        ring->tail = 0;
+        return ring;
+    }
+
+    crd_module void destroy_staging_ring(const Context& context, StagingRing*& ring) noexcept {
+        crd_profile_scoped();
+        crd_assert(ring->in_flight.empty(), "staging ring destroyed while blocks are still in flight");
+        vmaDestroyBuffer(context.allocator, ring->buffer.handle, ring->buffer.allocation);
+        delete ring;
+        ring = nullptr;
+    }
+
+    crd_nodiscard crd_module StagingBlock StagingRing::allocate(const Context& context, std::size_t size, std::size_t alignment) noexcept {
+        crd_profile_scoped();
+        // Never hand out empty blocks, their end would alias the previous block.
+        const auto reserved = std::max<std::size_t>(size, 1);
+        StagingBlock block;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            // Positions are monotonic, the physical offset is the position modulo the capacity.
+            auto start = align_up(head, alignment);
+            const auto physical = start % buffer.capacity;
+            crd_unlikely_if(physical + reserved > buffer.capacity) {
+                start += buffer.capacity - physical;
+            }
+            crd_likely_if(start + reserved - tail <= buffer.capacity) {
+                head = start + reserved;
+                in_flight.push_back({ head, false });
+                block.buffer = &buffer;
+                block.offset = start % buffer.capacity;
+                block.size = size;
+                block.end = head;
+                block.mapped = static_cast<char*>(buffer.mapped) + block.offset;
+                block.dedicated = false;
+                return block;
+            }
+        }
+        spdlog::debug("staging ring exhausted, allocating a dedicated buffer of {} bytes", size);
+        block.buffer = new StaticBuffer(make_static_buffer(context, {
+            .flags = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            .usage = VMA_MEMORY_USAGE_CPU_ONLY,
+            .capacity = reserved
+        }));
+        block.offset = 0;
+        block.size = size;
+        block.end = 0;
+        block.mapped = block.buffer->mapped;
+        block.dedicated = true;
+        return block;
+    }
+
+    crd_module void StagingRing::release(const StagingBlock& block) noexcept {
+        crd_profile_scoped();
+        crd_unlikely_if(block.dedicated) {
+            block.buffer->destroy();
+            delete block.buffer;
+            return;
+        }
+        std::lock_guard<std::mutex> guard(lock);
+        const auto retire = std::find_if(in_flight.begin(), in_flight.end(), [&block](const auto& each) noexcept {
+            return each.end == block.end;
+        });
+        crd_assert(retire != in_flight.end(), "released a block which doesn't belong to the staging ring");
+        retire->released = true;
+        while (!in_flight.empty() && in_flight.front().released) {
+            tail = in_flight.front().end;
+            in_flight.pop_front();
+        }
+    }
+} // namespace crd
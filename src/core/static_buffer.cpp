@@ -8,6 +8,10 @@
 
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
 namespace crd {
     crd_nodiscard crd_module StaticBuffer make_static_buffer(const Context& context, StaticBuffer::CreateInfo&& info) noexcept {
         crd_profile_scoped();
@@ -23,6 +27,21 @@ namespace crd {
         buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
         buffer_info.queueFamilyIndexCount = 0;
         buffer_info.pQueueFamilyIndices = nullptr;
+        std::vector<std::uint32_t> families;
+        if (info.shared) {
+            for (const auto family : { context.families.graphics.family,
+                                       context.families.transfer.family,
+                                       context.families.compute.family }) {
+                if (std::find(families.begin(), families.end(), family) == families.end()) {
+                    families.emplace_back(family);
+                }
+            }
+            if (families.size() > 1) {
+                buffer_info.sharingMode = VK_SHARING_MODE_CONCURRENT;
+                buffer_info.queueFamilyIndexCount = families.size();
+                buffer_info.pQueueFamilyIndices = families.data();
+            }
+        }
 
         VmaAllocationCreateInfo allocation_info;
         allocation_info.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
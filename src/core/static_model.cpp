@@ -1,9 +1,16 @@
+#include <corundum/core/texture_registry.hpp>
 #include <corundum/core/static_texture.hpp>
+#include <corundum/core/staging_ring.hpp>
+#include <corundum/core/file_reader.hpp>
 #include <corundum/core/static_model.hpp>
 #include <corundum/core/static_mesh.hpp>
 #include <corundum/core/renderer.hpp>
+#include <corundum/core/utilities.hpp>
 #include <corundum/core/context.hpp>
 
+#include <corundum/detail/mesh_optimizer.hpp>
+#include <corundum/detail/model_format.hpp>
+#include <corundum/detail/interleave.hpp>
 #include <corundum/detail/file_view.hpp>
 
 #include <assimp/DefaultIOStream.h>
@@ -20,21 +27,68 @@
 
 #include <spdlog/spdlog.h>
 
+#include <ftl/task_scheduler.h>
+#include <ftl/wait_group.h>
+
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/geometric.hpp>
+#include <glm/packing.hpp>
+#include <glm/matrix.hpp>
+#include <glm/vec4.hpp>
 #include <glm/vec3.hpp>
 #include <glm/vec2.hpp>
 
 #include <unordered_set>
 #include <unordered_map>
 #include <filesystem>
+#include <optional>
+#include <limits>
 #include <algorithm>
-#include <fstream>
+#include <mutex>
+#include <cstring>
+#include <cmath>
 #include <string>
 #include <vector>
 
 namespace crd {
+    // One registry reference per texture file the model uses, released by StaticModel::destroy.
     using TextureCache = std::unordered_map<std::string, Async<StaticTexture>*>;
     namespace fs = std::filesystem;
 
+    struct CompactVertex {
+        float position[3];
+        std::uint32_t normal;
+        std::uint32_t uv;
+        std::uint32_t tangent;
+    };
+    static_assert(sizeof(CompactVertex) == compact_vertex_size);
+
+    // Shared by every mesh conversion task of one model.
+    struct ModelImport {
+        const Context* context;
+        Renderer* renderer;
+        const aiScene* scene;
+        fs::path path;
+        VertexFormat format;
+        TextureCache cache;
+        std::mutex lock;
+    };
+
+    struct MeshImportJob {
+        ModelImport* state;
+        const aiMesh* mesh;
+        TexturedMesh* result;
+    };
+
+    struct CookedMeshJob {
+        const Context* context;
+        const AsyncFile* file;
+        const dtl::CookedSubmesh* submesh;
+        VertexFormat format;
+        TexturedMesh* result;
+        bool failed;
+    };
+
     struct FileViewStream : Assimp::IOStream {
         dtl::FileView handle;
         std::size_t offset;
@@ -96,7 +150,7 @@ namespace crd {
     struct FileViewSystem : Assimp::IOSystem {
         crd_nodiscard bool Exists(const char* path) const noexcept override {
             crd_profile_scoped();
-            return std::ifstream(path).is_open();
+            return dtl::file_exists(path);
         }
 
         crd_nodiscard char getOsSeparator() const noexcept override {
@@ -115,62 +169,115 @@ namespace crd {
         }
     };
 
-    crd_nodiscard static inline Async<StaticTexture>* import_texture(const Context& context, Renderer& renderer, const aiMaterial* material, aiTextureType type, TextureCache& cache, const fs::path& path) noexcept {
+    // Path of the material's texture relative to the model, empty if it has none.
+    crd_nodiscard static inline std::string texture_path(const aiMaterial* material, aiTextureType type) noexcept {
         crd_profile_scoped();
         crd_unlikely_if(type == aiTextureType_HEIGHT && material->GetTextureCount(type) == 0) {
             type = aiTextureType_NORMALS;
         }
         crd_unlikely_if(material->GetTextureCount(type) == 0) {
-            return nullptr;
+            return {};
         }
         aiString str;
         material->GetTexture(type, 0, &str);
-        auto file_name = (path / str.C_Str()).generic_string();
-        std::replace(file_name.begin(), file_name.end(), '\\', '/');
-        const auto format = type == aiTextureType_DIFFUSE ? texture_srgb : texture_unorm;
-        const auto [cached, miss] = cache.try_emplace(file_name);
+        std::string path = str.C_Str();
+        std::replace(path.begin(), path.end(), '\\', '/');
+        return path;
+    }
+
+    crd_nodiscard static inline Async<StaticTexture>* acquire_texture(ModelImport& state, const std::string& path, TextureFormat format) noexcept {
+        crd_profile_scoped();
+        crd_unlikely_if(path.empty()) {
+            return nullptr;
+        }
+        auto file_name = (state.path / path).generic_string();
+        std::lock_guard<std::mutex> guard(state.lock);
+        const auto [cached, miss] = state.cache.try_emplace(file_name);
         crd_unlikely_if(miss) {
-            cached->second = new Async<StaticTexture>(request_static_texture(renderer, std::move(file_name), format));
+            cached->second = state.renderer->textures->acquire(*state.renderer, std::move(file_name), format, texture_load_streamed);
         }
         return cached->second;
     }
 
-    crd_nodiscard static inline TexturedMesh import_textured_mesh(const Context& context, Renderer& renderer, const aiScene* scene, const aiMesh* mesh, TextureCache& cache, const fs::path& path) noexcept {
+    crd_nodiscard static inline Async<StaticTexture>* import_texture(ModelImport& state, const aiMaterial* material, aiTextureType type) noexcept {
         crd_profile_scoped();
-        std::vector<float> geometry;
-        geometry.resize(mesh->mNumVertices * vertex_components);
-        auto ptr = &geometry.front();
-        for (std::size_t i = 0; i < mesh->mNumVertices; ++i) {
-            ptr[0] = mesh->mVertices[i].x;
-            ptr[1] = mesh->mVertices[i].y;
-            ptr[2] = mesh->mVertices[i].z;
+        const auto format = type == aiTextureType_DIFFUSE ? texture_srgb : texture_unorm;
+        return acquire_texture(state, texture_path(material, type), format);
+    }
 
+    // Maps a unit vector onto the [-1, 1] square, see "A Survey of Efficient Representations for Independent Unit Vectors".
+    crd_nodiscard static inline glm::vec2 encode_octahedral(glm::vec3 vector) noexcept {
+        crd_profile_scoped();
+        const auto length = std::abs(vector.x) + std::abs(vector.y) + std::abs(vector.z);
+        crd_unlikely_if(length == 0) {
+            return glm::vec2(0);
+        }
+        vector /= length;
+        crd_unlikely_if(vector.z < 0) {
+            return {
+                (1 - std::abs(vector.y)) * (vector.x >= 0 ? 1.0f : -1.0f),
+                (1 - std::abs(vector.x)) * (vector.y >= 0 ? 1.0f : -1.0f)
+            };
+        }
+        return { vector.x, vector.y };
+    }
+
+    static inline void encode_compact_geometry(const aiMesh* mesh, std::vector<std::uint8_t>& geometry) noexcept {
+        crd_profile_scoped();
+        geometry.resize(mesh->mNumVertices * compact_vertex_size);
+        auto ptr = reinterpret_cast<CompactVertex*>(geometry.data());
+        for (std::size_t i = 0; i < mesh->mNumVertices; ++i, ++ptr) {
+            ptr->position[0] = mesh->mVertices[i].x;
+            ptr->position[1] = mesh->mVertices[i].y;
+            ptr->position[2] = mesh->mVertices[i].z;
+
+            auto normal = glm::vec3(0, 0, 1);
             crd_likely_if(mesh->mNormals) {
-                ptr[3] = mesh->mNormals[i].x;
-                ptr[4] = mesh->mNormals[i].y;
-                ptr[5] = mesh->mNormals[i].z;
+                normal = { mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z };
             }
+            ptr->normal = glm::packSnorm2x16(encode_octahedral(normal));
 
+            auto uv = glm::vec2(0);
             crd_likely_if(mesh->mTextureCoords[0]) {
-                ptr[6] = mesh->mTextureCoords[0][i].x;
-                ptr[7] = mesh->mTextureCoords[0][i].y;
+                uv = { mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y };
             }
+            ptr->uv = glm::packHalf2x16(uv);
 
+            auto tangent = glm::vec3(1, 0, 0);
+            auto sign = 1.0f;
             crd_likely_if(mesh->mTangents) {
-                ptr[8] = mesh->mTangents[i].x;
-                ptr[9] = mesh->mTangents[i].y;
-                ptr[10] = mesh->mTangents[i].z;
+                tangent = { mesh->mTangents[i].x, mesh->mTangents[i].y, mesh->mTangents[i].z };
             }
-
             crd_likely_if(mesh->mBitangents) {
-                ptr[11] = mesh->mBitangents[i].x;
-                ptr[12] = mesh->mBitangents[i].y;
-                ptr[13] = mesh->mBitangents[i].z;
+                const auto bitangent = glm::vec3(mesh->mBitangents[i].x, mesh->mBitangents[i].y, mesh->mBitangents[i].z);
+                // The bitangent is rebuilt as cross(normal, tangent) * sign in the vertex shader.
+                sign = glm::dot(glm::cross(normal, tangent), bitangent) < 0 ? -1.0f : 1.0f;
             }
-            ptr += vertex_components;
+            ptr->tangent = glm::packSnorm4x8(glm::vec4(encode_octahedral(tangent), sign, 0));
+        }
+    }
+
+    static inline void encode_float_geometry(const aiMesh* mesh, std::vector<std::uint8_t>& geometry) noexcept {
+        crd_profile_scoped();
+        static_assert(sizeof(aiVector3D) == sizeof(float[3]), "interleaving requires single precision Assimp vectors");
+        static_assert(vertex_components == 14, "dtl::interleave_vertices writes the 14-float layout");
+        geometry.resize(mesh->mNumVertices * vertex_size);
+        dtl::interleave_vertices({
+            .positions = &mesh->mVertices[0].x,
+            .normals = mesh->mNormals ? &mesh->mNormals[0].x : nullptr,
+            .uvs = mesh->mTextureCoords[0] ? &mesh->mTextureCoords[0][0].x : nullptr,
+            .tangents = mesh->mTangents ? &mesh->mTangents[0].x : nullptr,
+            .bitangents = mesh->mBitangents ? &mesh->mBitangents[0].x : nullptr
+        }, mesh->mNumVertices, reinterpret_cast<float*>(geometry.data()));
+    }
+
+    static inline void convert_mesh(const aiMesh* mesh, VertexFormat format, std::vector<std::uint8_t>& geometry, std::vector<std::uint32_t>& indices) noexcept {
+        crd_profile_scoped();
+        switch (format) {
+            case vertex_format_float:   encode_float_geometry(mesh, geometry); break;
+            case vertex_format_compact: encode_compact_geometry(mesh, geometry); break;
         }
 
-        std::vector<std::uint32_t> indices;
         indices.reserve(mesh->mNumFaces * mesh->mFaces[0].mNumIndices);
         for (std::size_t i = 0; i < mesh->mNumFaces; i++) {
             auto& face = mesh->mFaces[i];
@@ -178,54 +285,282 @@ namespace crd {
                 indices.emplace_back(face.mIndices[j]);
             }
         }
-        const auto material = scene->mMaterials[mesh->mMaterialIndex];
-        const auto vertices_size = mesh->mNumVertices;
+        // Runs after encoding, so vertices which only differ below the format's precision are welded too.
+        dtl::optimize_mesh(geometry, indices, vertex_stride(format));
+    }
+
+    crd_nodiscard static inline TexturedMesh import_textured_mesh(ModelImport& state, const aiMesh* mesh) noexcept {
+        crd_profile_scoped();
+        const auto format = state.format;
+        std::vector<std::uint8_t> geometry;
+        std::vector<std::uint32_t> indices;
+        convert_mesh(mesh, format, geometry, indices);
+        const auto material = state.scene->mMaterials[mesh->mMaterialIndex];
+        const auto vertices_size = geometry.size() / vertex_stride(format);
         const auto index_size = indices.size();
+        // The optimized buffers go straight into staging, the upload itself runs as its own task.
+        auto builder = reserve_static_mesh(*state.context, format, vertices_size, index_size);
+        std::memcpy(builder.vertices.data(), geometry.data(), geometry.size());
+        builder.write_indices(indices);
         return {
-            .mesh = request_static_mesh(context, { std::move(geometry), std::move(indices) }),
-            .diffuse = import_texture(context, renderer, material, aiTextureType_DIFFUSE, cache, path),
-            .normal = import_texture(context, renderer, material, aiTextureType_HEIGHT, cache, path),
-            .specular = import_texture(context, renderer, material, aiTextureType_SPECULAR, cache, path),
+            .mesh = commit_static_mesh(std::move(builder)),
+            .diffuse = import_texture(state, material, aiTextureType_DIFFUSE),
+            .normal = import_texture(state, material, aiTextureType_HEIGHT),
+            .specular = import_texture(state, material, aiTextureType_SPECULAR),
             .vertices = static_cast<std::uint32_t>(vertices_size),
             .indices = static_cast<std::uint32_t>(index_size)
         };
     }
 
-    static inline void process_node(const Context& context, Renderer& renderer, const aiScene* scene, const aiNode* node, StaticModel& model, TextureCache& cache, fs::path path) noexcept {
+    struct SceneMeshes {
+        // Every referenced aiMesh once, in first reference order.
+        std::vector<const aiMesh*> meshes;
+        // Index into meshes of every aiMesh in the scene, or -1 while unreferenced.
+        std::vector<std::int32_t> remap;
+        std::vector<StaticModel::Instance> instances;
+    };
+
+    static inline void collect_meshes(const aiScene* scene, const aiNode* node, const glm::mat4& parent, SceneMeshes& result) noexcept {
+        // aiMatrix4x4 is row major.
+        const auto transform = parent * glm::transpose(glm::make_mat4(&node->mTransformation.a1));
         for (std::size_t i = 0; i < node->mNumMeshes; i++) {
-            model.submeshes.emplace_back(import_textured_mesh(context, renderer, scene, scene->mMeshes[node->mMeshes[i]], cache, path));
+            auto& submesh = result.remap[node->mMeshes[i]];
+            crd_unlikely_if(submesh == -1) {
+                submesh = result.meshes.size();
+                result.meshes.emplace_back(scene->mMeshes[node->mMeshes[i]]);
+            }
+            result.instances.push_back({ static_cast<std::uint32_t>(submesh), transform });
         }
 
         for (std::size_t i = 0; i < node->mNumChildren; i++) {
-            process_node(context, renderer, scene, node->mChildren[i], model, cache, path);
+            collect_meshes(scene, node->mChildren[i], transform, result);
+        }
+    }
+
+    crd_nodiscard static inline SceneMeshes collect_meshes(const aiScene* scene) noexcept {
+        crd_profile_scoped();
+        SceneMeshes result;
+        result.remap.resize(scene->mNumMeshes, -1);
+        collect_meshes(scene, scene->mRootNode, glm::mat4(1.0f), result);
+        return result;
+    }
+
+    crd_nodiscard static inline const aiScene* read_scene(Assimp::Importer& importer, const std::string& path) noexcept {
+        crd_profile_scoped();
+        const auto post_process =
+            aiProcess_Triangulate |
+            aiProcess_FlipUVs     |
+            aiProcess_GenNormals  |
+            aiProcess_CalcTangentSpace;
+        importer.SetIOHandler(new FileViewSystem());
+        const auto scene = importer.ReadFile(path, post_process);
+        crd_unlikely_if(!scene || !scene->mRootNode) {
+            spdlog::critical("Failed to load model \"{}\", error: {}", path, importer.GetErrorString());
+            return nullptr;
+        }
+        return scene;
+    }
+
+    crd_nodiscard static inline StaticModel import_model(Renderer& renderer, const std::string& path, VertexFormat format) noexcept {
+        crd_profile_scoped();
+        const auto context = renderer.context;
+        Assimp::Importer importer;
+        const auto scene = read_scene(importer, path);
+        crd_unlikely_if(!scene) {
+            crd_panic();
+        }
+        ModelImport state;
+        state.context = context;
+        state.renderer = &renderer;
+        state.scene = scene;
+        state.path = fs::path(path).parent_path();
+        state.format = format;
+        state.cache.reserve(128);
+        auto [meshes, remap, instances] = collect_meshes(scene);
+        StaticModel model;
+        model.context = context;
+        model.renderer = &renderer;
+        // Every conversion writes to its own slot, submeshes keep the order of first reference.
+        model.submeshes.resize(meshes.size());
+        model.instances = std::move(instances);
+        std::vector<MeshImportJob> jobs;
+        std::vector<ftl::Task> tasks;
+        jobs.reserve(meshes.size());
+        tasks.reserve(meshes.size());
+        for (std::size_t i = 0; i < meshes.size(); ++i) {
+            jobs.push_back({ &state, meshes[i], &model.submeshes[i] });
+            tasks.push_back({
+                .Function = +[](ftl::TaskScheduler*, void* data) {
+                    crd_profile_scoped();
+                    auto job = static_cast<MeshImportJob*>(data);
+                    *job->result = import_textured_mesh(*job->state, job->mesh);
+                },
+                .ArgData = &jobs.back()
+            });
+        }
+        ftl::WaitGroup waiter(context->scheduler);
+        context->scheduler->AddTasks(tasks.size(), tasks.data(), ftl::TaskPriority::High, &waiter);
+        waiter.Wait();
+        spdlog::info("StaticModel \"{}\" was loaded successfully", path);
+        return model;
+    }
+
+    // Reads a .crdm container through the file reader, every submesh lands straight in its staging reservation.
+    // Returns nothing when the container cannot be read, is not a .crdm of this version or was cooked with a
+    // different vertex format, the source is imported instead.
+    crd_nodiscard static inline std::optional<StaticModel> load_cooked_model(Renderer& renderer, const std::string& path, VertexFormat format) noexcept {
+        crd_profile_scoped();
+        const auto context = renderer.context;
+        auto file = open_file(path.c_str(), file_access_sequential);
+        dtl::CookedModelHeader header;
+        crd_unlikely_if(!read_file(*context, file, &header, sizeof(header))) {
+            spdlog::error("failed to read cooked model \"{}\"", path);
+            close_file(file);
+            return std::nullopt;
+        }
+        crd_unlikely_if(header.magic != dtl::cooked_model_magic || header.version != dtl::cooked_model_version) {
+            spdlog::error("\"{}\" is not a cooked model of version {}", path, dtl::cooked_model_version);
+            close_file(file);
+            return std::nullopt;
+        }
+        crd_unlikely_if(header.format != format) {
+            spdlog::warn("cooked model \"{}\" was encoded with a different vertex format than requested", path);
+            close_file(file);
+            return std::nullopt;
+        }
+        // The submesh, instance and path tables directly follow the header.
+        const auto tables_end = sizeof(header) + header.submeshes * sizeof(dtl::CookedSubmesh) + header.instances * sizeof(dtl::CookedInstance);
+        crd_unlikely_if(header.strings_offset != tables_end || header.strings_size > file.size - std::min(tables_end, file.size)) {
+            spdlog::error("cooked model \"{}\" is truncated", path);
+            close_file(file);
+            return std::nullopt;
+        }
+        const auto tables_size = header.strings_offset + header.strings_size - sizeof(header);
+        auto tables = context->reader->acquire(tables_size);
+        crd_unlikely_if(!read_file(*context, file, tables.data, tables_size, sizeof(header))) {
+            spdlog::error("failed to read cooked model \"{}\"", path);
+            context->reader->release(tables);
+            close_file(file);
+            return std::nullopt;
+        }
+        std::vector<dtl::CookedSubmesh> submeshes(header.submeshes);
+        std::memcpy(submeshes.data(), tables.data, size_bytes(submeshes));
+        std::vector<dtl::CookedInstance> instances(header.instances);
+        std::memcpy(instances.data(), tables.data + size_bytes(submeshes), size_bytes(instances));
+        const auto strings = reinterpret_cast<const char*>(tables.data + header.strings_offset - sizeof(header));
+        // Texture paths must start and be terminated within the path table.
+        const auto is_valid_path = [&header, strings](std::uint32_t offset) noexcept {
+            return
+                offset == dtl::cooked_no_texture ||
+                (offset < header.strings_size && std::memchr(strings + offset, '\0', header.strings_size - offset));
+        };
+        for (const auto& submesh : submeshes) {
+            // A container cooked by a build with different index narrowing (ray tracing keeps 32 bit indices) is reimported.
+            crd_unlikely_if(static_cast<VkIndexType>(submesh.index_type) != narrowed_index_type(submesh.vertex_count)) {
+                spdlog::warn("cooked model \"{}\" was encoded with a different index narrowing than this build uses", path);
+                context->reader->release(tables);
+                close_file(file);
+                return std::nullopt;
+            }
+            crd_unlikely_if(!std::all_of(std::begin(submesh.textures), std::end(submesh.textures), is_valid_path)) {
+                spdlog::error("cooked model \"{}\" references a texture path outside of its path table", path);
+                context->reader->release(tables);
+                close_file(file);
+                return std::nullopt;
+            }
+        }
+        for (const auto& instance : instances) {
+            crd_unlikely_if(instance.submesh >= header.submeshes) {
+                spdlog::error("cooked model \"{}\" instances a submesh it does not hold", path);
+                context->reader->release(tables);
+                close_file(file);
+                return std::nullopt;
+            }
+        }
+        const auto texture = [strings](std::uint32_t offset) noexcept -> std::string {
+            return offset == dtl::cooked_no_texture ? std::string() : std::string(strings + offset);
+        };
+
+        ModelImport state;
+        state.context = context;
+        state.renderer = &renderer;
+        state.scene = nullptr;
+        state.path = fs::path(path).parent_path();
+        state.format = format;
+        state.cache.reserve(128);
+        StaticModel model;
+        model.context = context;
+        model.renderer = &renderer;
+        model.submeshes.resize(submeshes.size());
+        model.instances.reserve(instances.size());
+        for (const auto& instance : instances) {
+            model.instances.push_back({ instance.submesh, glm::make_mat4(instance.transform) });
+        }
+        std::vector<CookedMeshJob> jobs;
+        std::vector<ftl::Task> tasks;
+        jobs.reserve(submeshes.size());
+        tasks.reserve(submeshes.size());
+        for (std::size_t i = 0; i < submeshes.size(); ++i) {
+            const auto& submesh = submeshes[i];
+            auto& result = model.submeshes[i];
+            result.diffuse = acquire_texture(state, texture(submesh.textures[0]), texture_srgb);
+            result.normal = acquire_texture(state, texture(submesh.textures[1]), texture_unorm);
+            result.specular = acquire_texture(state, texture(submesh.textures[2]), texture_unorm);
+            result.vertices = submesh.vertex_count;
+            result.indices = submesh.index_count;
+            jobs.push_back({ context, &file, &submesh, format, &result, false });
+            tasks.push_back({
+                .Function = +[](ftl::TaskScheduler*, void* data) {
+                    crd_profile_scoped();
+                    auto job = static_cast<CookedMeshJob*>(data);
+                    const auto& submesh = *job->submesh;
+                    auto builder = reserve_static_mesh(*job->context, job->format, submesh.vertex_count, submesh.index_count);
+                    crd_assert(builder.index_type == static_cast<VkIndexType>(submesh.index_type), "cooked indices do not match the runtime narrowing");
+                    // Indices directly follow the vertices both in the file and in staging.
+                    const auto index_bytes = builder.indices16.size_bytes() + builder.indices32.size_bytes();
+                    crd_unlikely_if(!read_file(*job->context, *job->file, builder.vertices.data(), builder.vertices.size_bytes() + index_bytes, submesh.offset)) {
+                        job->context->staging->release(builder.staging);
+                        job->failed = true;
+                        return;
+                    }
+                    job->result->mesh = make_async(make_static_mesh(std::move(builder)));
+                },
+                .ArgData = &jobs.back()
+            });
         }
+        ftl::WaitGroup waiter(context->scheduler);
+        context->scheduler->AddTasks(tasks.size(), tasks.data(), ftl::TaskPriority::High, &waiter);
+        waiter.Wait();
+        context->reader->release(tables);
+        close_file(file);
+        const auto failed = std::any_of(jobs.begin(), jobs.end(), [](const CookedMeshJob& job) noexcept {
+            return job.failed;
+        });
+        crd_unlikely_if(failed) {
+            spdlog::error("failed to read the geometry of cooked model \"{}\"", path);
+            model.destroy();
+            return std::nullopt;
+        }
+        spdlog::info("StaticModel \"{}\" was loaded successfully", path);
+        return model;
     }
 
-    crd_nodiscard crd_module Async<StaticModel> request_static_model(Renderer& renderer, std::string&& path) noexcept {
+    crd_nodiscard crd_module Async<StaticModel> request_static_model(Renderer& renderer, std::string&& path, VertexFormat format) noexcept {
         crd_profile_scoped();
         spdlog::info("loading model: \"{}\"", path);
         using task_type = std::packaged_task<StaticModel()>;
         const auto context = renderer.context;
-        auto task = new task_type([context, &renderer, path = std::move(path)]() noexcept -> StaticModel {
+        auto task = new task_type([&renderer, path = std::move(path), format]() noexcept -> StaticModel {
             crd_profile_scoped();
-            Assimp::Importer importer;
-            const auto post_process =
-                aiProcess_Triangulate |
-                aiProcess_FlipUVs     |
-                aiProcess_GenNormals  |
-                aiProcess_CalcTangentSpace;
-            importer.SetIOHandler(new FileViewSystem());
-            const auto scene = importer.ReadFile(path, post_process);
-            crd_unlikely_if(!scene || !scene->mRootNode) {
-                spdlog::critical("Failed to load model \"{}\", error: {}", path, importer.GetErrorString());
-                crd_panic();
+            // A cooked container next to the source (same name, .crdm extension) wins if it has the same vertex format.
+            const auto cooked = fs::path(path).replace_extension(".crdm");
+            crd_likely_if(dtl::file_exists(cooked.generic_string().c_str())) {
+                auto model = load_cooked_model(renderer, cooked.generic_string(), format);
+                crd_likely_if(model) {
+                    return std::move(*model);
+                }
             }
-            TextureCache cache;
-            cache.reserve(128);
-            StaticModel model;
-            process_node(*context, renderer, scene, scene->mRootNode, model, cache, fs::path(path).parent_path());
-            spdlog::info("StaticModel \"{}\" was loaded successfully", path);
-            return model;
+            return import_model(renderer, path, format);
         });
         auto future = task->get_future();
         context->scheduler->AddTask({
@@ -240,12 +575,123 @@ namespace crd {
         return make_async(std::move(future));
     }
 
+    crd_nodiscard crd_module std::vector<std::uint8_t> cook_static_model(const std::string& path, VertexFormat format) noexcept {
+        crd_profile_scoped();
+        Assimp::Importer importer;
+        const auto scene = read_scene(importer, path);
+        crd_unlikely_if(!scene) {
+            return {};
+        }
+        const auto [meshes, remap, instances] = collect_meshes(scene);
+
+        dtl::CookedModelHeader header = {};
+        header.magic = dtl::cooked_model_magic;
+        header.version = dtl::cooked_model_version;
+        header.format = format;
+        header.submeshes = meshes.size();
+        header.instances = instances.size();
+        std::fill(std::begin(header.min), std::end(header.min), std::numeric_limits<float>::max());
+        std::fill(std::begin(header.max), std::end(header.max), std::numeric_limits<float>::lowest());
+        std::vector<dtl::CookedSubmesh> submeshes(meshes.size());
+        std::vector<std::vector<std::uint8_t>> blobs(meshes.size());
+        std::unordered_map<std::string, std::uint32_t> interned;
+        std::string strings;
+        const auto intern = [&](std::string&& texture) -> std::uint32_t {
+            crd_unlikely_if(texture.empty()) {
+                return dtl::cooked_no_texture;
+            }
+            const auto [cached, miss] = interned.try_emplace(texture, (std::uint32_t)strings.size());
+            crd_unlikely_if(miss) {
+                strings += texture;
+                strings += '\0';
+            }
+            return cached->second;
+        };
+        const auto stride = vertex_stride(format);
+        for (std::size_t i = 0; i < meshes.size(); ++i) {
+            std::vector<std::uint32_t> indices;
+            auto& geometry = blobs[i];
+            convert_mesh(meshes[i], format, geometry, indices);
+            auto& submesh = submeshes[i];
+            submesh.vertex_count = geometry.size() / stride;
+            submesh.index_count = indices.size();
+            std::fill(std::begin(submesh.min), std::end(submesh.min), std::numeric_limits<float>::max());
+            std::fill(std::begin(submesh.max), std::end(submesh.max), std::numeric_limits<float>::lowest());
+            // Both vertex formats lead with a float3 position.
+            for (std::size_t vertex = 0; vertex < submesh.vertex_count; ++vertex) {
+                float position[3];
+                std::memcpy(position, geometry.data() + vertex * stride, sizeof(position));
+                for (std::size_t axis = 0; axis < 3; ++axis) {
+                    submesh.min[axis] = std::min(submesh.min[axis], position[axis]);
+                    submesh.max[axis] = std::max(submesh.max[axis], position[axis]);
+                }
+            }
+            // Same narrowing as reserve_static_mesh, so the runtime copies the indices as they are.
+            const auto vertex_bytes = geometry.size();
+            submesh.index_type = narrowed_index_type(submesh.vertex_count);
+            crd_likely_if(submesh.index_type == VK_INDEX_TYPE_UINT16) {
+                geometry.resize(vertex_bytes + indices.size() * sizeof(std::uint16_t));
+                std::copy(indices.begin(), indices.end(), reinterpret_cast<std::uint16_t*>(geometry.data() + vertex_bytes));
+            } else {
+                geometry.resize(vertex_bytes + size_bytes(indices));
+                std::memcpy(geometry.data() + vertex_bytes, indices.data(), size_bytes(indices));
+            }
+            const auto material = scene->mMaterials[meshes[i]->mMaterialIndex];
+            submesh.textures[0] = intern(texture_path(material, aiTextureType_DIFFUSE));
+            submesh.textures[1] = intern(texture_path(material, aiTextureType_HEIGHT));
+            submesh.textures[2] = intern(texture_path(material, aiTextureType_SPECULAR));
+        }
+
+        // The model bounds enclose every placed instance, submesh bounds stay in mesh space.
+        std::vector<dtl::CookedInstance> cooked_instances(instances.size());
+        for (std::size_t i = 0; i < instances.size(); ++i) {
+            const auto& [index, transform] = instances[i];
+            const auto& submesh = submeshes[index];
+            cooked_instances[i].submesh = index;
+            std::memcpy(cooked_instances[i].transform, glm::value_ptr(transform), sizeof(cooked_instances[i].transform));
+            for (std::uint32_t corner = 0; corner < 8; ++corner) {
+                const auto position = transform * glm::vec4(
+                    corner & 1 ? submesh.max[0] : submesh.min[0],
+                    corner & 2 ? submesh.max[1] : submesh.min[1],
+                    corner & 4 ? submesh.max[2] : submesh.min[2],
+                    1.0f);
+                for (std::size_t axis = 0; axis < 3; ++axis) {
+                    header.min[axis] = std::min(header.min[axis], position[axis]);
+                    header.max[axis] = std::max(header.max[axis], position[axis]);
+                }
+            }
+        }
+
+        const auto align = [](std::size_t offset) noexcept {
+            return (offset + 15) & ~(std::size_t)15;
+        };
+        header.strings_offset = sizeof(header) + size_bytes(submeshes) + size_bytes(cooked_instances);
+        header.strings_size = strings.size();
+        auto offset = align(header.strings_offset + header.strings_size);
+        for (std::size_t i = 0; i < meshes.size(); ++i) {
+            submeshes[i].offset = offset;
+            offset = align(offset + blobs[i].size());
+        }
+        std::vector<std::uint8_t> cooked(offset);
+        std::memcpy(cooked.data(), &header, sizeof(header));
+        std::memcpy(cooked.data() + sizeof(header), submeshes.data(), size_bytes(submeshes));
+        std::memcpy(cooked.data() + sizeof(header) + size_bytes(submeshes), cooked_instances.data(), size_bytes(cooked_instances));
+        std::memcpy(cooked.data() + header.strings_offset, strings.data(), strings.size());
+        for (std::size_t i = 0; i < meshes.size(); ++i) {
+            std::memcpy(cooked.data() + submeshes[i].offset, blobs[i].data(), blobs[i].size());
+        }
+        return cooked;
+    }
+
     crd_module void StaticModel::destroy() noexcept {
         crd_profile_scoped();
         std::unordered_set<Async<StaticTexture>*> to_destroy;
         to_destroy.reserve(submeshes.size() * 3);
         for (auto& each : submeshes) {
-            each.mesh->destroy();
+            // Null when a cooked model failed to load part way through.
+            crd_likely_if(each.mesh.tag != task_tag_none) {
+                each.mesh->destroy();
+            }
             to_destroy.emplace(each.diffuse);
             to_destroy.emplace(each.normal);
             to_destroy.emplace(each.specular);
@@ -254,9 +700,9 @@ namespace crd {
         if (empty != to_destroy.end()) {
             to_destroy.erase(empty);
         }
+        // Every texture was acquired once per model, see import_texture.
         for (auto each : to_destroy) {
-            (*each)->destroy();
-            delete each;
+            renderer->textures->release(each);
         }
         *this = {};
     }
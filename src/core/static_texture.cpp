@@ -1,11 +1,15 @@
+#include <corundum/core/texture_streamer.hpp>
 #include <corundum/core/static_texture.hpp>
 #include <corundum/core/command_buffer.hpp>
 #include <corundum/core/static_buffer.hpp>
+#include <corundum/core/staging_ring.hpp>
+#include <corundum/core/bindless.hpp>
 #include <corundum/core/renderer.hpp>
 #include <corundum/core/context.hpp>
 #include <corundum/core/async.hpp>
 #include <corundum/core/queue.hpp>
 
+#include <corundum/detail/texture_codec.hpp>
 #include <corundum/detail/file_view.hpp>
 
 #if defined(crd_enable_profiling)
@@ -18,207 +22,233 @@
 
 #include <stb_image.h>
 
+#include <filesystem>
+#include <algorithm>
+#include <optional>
 #include <cstring>
 #include <future>
+#include <vector>
 #include <cmath>
 
 namespace crd {
-    crd_nodiscard crd_module Async<StaticTexture> request_static_texture(Renderer& renderer, std::string&& path, TextureFormat format) noexcept {
+    namespace fs = std::filesystem;
+
+    crd_nodiscard static inline VkFormat cooked_format(dtl::TextureCodec codec, TextureFormat format) noexcept {
+        const auto srgb = format == texture_srgb;
+        switch (codec) {
+            case dtl::texture_codec_bc1: return srgb ? VK_FORMAT_BC1_RGB_SRGB_BLOCK : VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+            case dtl::texture_codec_bc3: return srgb ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC3_UNORM_BLOCK;
+            case dtl::texture_codec_bc5: return VK_FORMAT_BC5_UNORM_BLOCK;
+            case dtl::texture_codec_bc7: return srgb ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+        }
+        crd_unreachable();
+    }
+
+    // Uploads the levels no larger than streaming_tail_size right away and hands the rest of the chain to
+    // the streamer, which owns the image from then on. Over budget, only those levels are allocated and the
+    // rest of the chain waits until the texture is used and there is room for it. Small textures are uploaded
+    // whole and not tracked.
+    crd_nodiscard static inline StaticTexture stream_texture(const Context& context, Image::CreateInfo&& info, TextureSource&& source) noexcept {
+        crd_profile_scoped();
+        const auto mips = info.mips;
+        std::uint32_t tail = 0;
+        while (tail + 1 < mips && std::max(info.width >> tail, info.height >> tail) > streaming_tail_size) {
+            tail++;
+        }
+        const auto& offsets = source.offsets;
+        const auto base = tail == 0 || context.streamer->has_room(offsets[mips] - offsets[0]) ? 0 : tail;
+        info.width = std::max(info.width >> base, 1u);
+        info.height = std::max(info.height >> base, 1u);
+        info.mips -= base;
+        auto image = make_image(context, std::move(info));
+        const auto bytes = offsets[mips] - offsets[tail];
+        const auto staging = context.staging->allocate(context, bytes);
+        std::memcpy(staging.mapped, source.data + offsets[tail], bytes);
+        std::vector<std::size_t> staged;
+        for (auto mip = tail; mip < mips; ++mip) {
+            staged.emplace_back(offsets[mip] - offsets[tail]);
+        }
+        upload_mips(context, image, staging, staged, tail - base);
+        context.staging->release(staging);
+        crd_unlikely_if(tail == 0) {
+            crd_likely_if(source.file.data) {
+                dtl::destroy_file_view(source.file);
+            }
+            return { image, nullptr, nullptr, nullptr, bindless_null_slot };
+        }
+        spdlog::info("StaticTexture published with {} of {} mips, {} bytes left to stream", mips - tail, mips, offsets[tail] - offsets[0]);
+        auto residency = make_texture_residency(context, image, std::move(source), base, tail);
+        context.streamer->track(residency);
+        return { {}, nullptr, residency, nullptr, bindless_null_slot };
+    }
+
+    // Decodes PNG/JPG sources and builds the mip chain on the CPU, straight into staging unless streamed.
+    crd_nodiscard static inline StaticTexture load_source_texture(const Context& context, const std::string& path, TextureFormat format, TextureLoad load) noexcept {
+        crd_profile_scoped();
+        std::int32_t width, height, channels = 4;
+        auto file = dtl::make_file_view(path.c_str());
+        auto image_data = stbi_load_from_memory(static_cast<const std::uint8_t*>(file.data), file.size, &width, &height, &channels, STBI_rgb_alpha);
+        if (!image_data) {
+            spdlog::info("error loading texture: {}", path);
+        }
+        dtl::destroy_file_view(file);
+        auto offsets = dtl::mip_chain_offsets(width, height);
+        spdlog::info("StaticTexture was asynchronously requested, expected bytes to transfer: {}", offsets.back());
+        Image::CreateInfo info = {
+            .width = (std::uint32_t)width,
+            .height = (std::uint32_t)height,
+            .mips = (std::uint32_t)offsets.size() - 1,
+            .layers = 1,
+            .format = static_cast<VkFormat>(format),
+            .aspect = VK_IMAGE_ASPECT_COLOR_BIT,
+            .samples = VK_SAMPLE_COUNT_1_BIT,
+            .usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+                     VK_IMAGE_USAGE_SAMPLED_BIT
+        };
+        crd_unlikely_if(load == texture_load_streamed) {
+            // The chain stays in memory with the texture, levels are copied from it whenever they are streamed in again.
+            TextureSource source = {};
+            source.chain.resize(offsets.back());
+            dtl::build_mips(image_data, width, height, format == texture_srgb, source.chain.data(), context.scheduler);
+            stbi_image_free(image_data);
+            source.data = source.chain.data();
+            source.offsets = std::move(offsets);
+            source.width = width;
+            source.height = height;
+            return stream_texture(context, std::move(info), std::move(source));
+        }
+        auto image = make_image(context, std::move(info));
+        const auto staging = context.staging->allocate(context, offsets.back());
+        dtl::build_mips(image_data, width, height, format == texture_srgb, static_cast<std::uint8_t*>(staging.mapped), context.scheduler);
+        stbi_image_free(image_data);
+        offsets.pop_back();
+        upload_mips(context, image, staging, offsets);
+        context.staging->release(staging);
+        return { image, nullptr, nullptr, nullptr, bindless_null_slot };
+    }
+
+    // Every level must lie within the file, after the previous one, and hold at least the blocks its extent needs.
+    crd_nodiscard static inline bool is_valid_cooked_texture(const dtl::CookedTextureHeader& header, const std::vector<dtl::CookedMip>& mips, std::size_t size) noexcept {
+        crd_profile_scoped();
+        std::uint64_t end = sizeof(header) + mips.size() * sizeof(dtl::CookedMip);
+        for (std::uint32_t level = 0; level < mips.size(); ++level) {
+            const auto& mip = mips[level];
+            const auto blocks_x = (std::max(header.width >> level, 1u) + 3) / 4;
+            const auto blocks_y = (std::max(header.height >> level, 1u) + 3) / 4;
+            crd_unlikely_if(mip.offset < end || mip.offset > size || mip.size > size - mip.offset ||
+                            mip.size < (std::uint64_t)blocks_x * blocks_y * dtl::block_size(header.codec)) {
+                return false;
+            }
+            end = mip.offset + mip.size;
+        }
+        return true;
+    }
+
+    // Maps a .crdt container and copies every pre-built mip straight into staging, no decoding and no blits.
+    // Streamed containers stay mapped for the lifetime of the texture. Returns nothing when the container is not
+    // a valid .crdt of this version, the source is decoded instead.
+    crd_nodiscard static inline std::optional<StaticTexture> load_cooked_texture(const Context& context, const std::string& path, TextureFormat format, TextureLoad load) noexcept {
+        crd_profile_scoped();
+        auto file = dtl::make_file_view(path.c_str());
+        const auto data = static_cast<const std::uint8_t*>(file.data);
+        dtl::CookedTextureHeader header;
+        crd_unlikely_if(file.size < sizeof(header)) {
+            spdlog::error("cooked texture \"{}\" is truncated", path);
+            dtl::destroy_file_view(file);
+            return std::nullopt;
+        }
+        std::memcpy(&header, data, sizeof(header));
+        crd_unlikely_if(
+            header.magic != dtl::cooked_texture_magic ||
+            header.version != dtl::cooked_texture_version ||
+            header.codec > dtl::texture_codec_bc7 ||
+            header.width == 0 || header.height == 0 ||
+            header.mips == 0 || header.mips > dtl::mip_count(header.width, header.height) ||
+            header.mips > (file.size - sizeof(header)) / sizeof(dtl::CookedMip)) {
+            spdlog::error("\"{}\" is not a cooked texture of version {}", path, dtl::cooked_texture_version);
+            dtl::destroy_file_view(file);
+            return std::nullopt;
+        }
+        std::vector<dtl::CookedMip> mips(header.mips);
+        std::memcpy(mips.data(), data + sizeof(header), mips.size() * sizeof(dtl::CookedMip));
+        crd_unlikely_if(!is_valid_cooked_texture(header, mips, file.size)) {
+            spdlog::error("cooked texture \"{}\" has levels outside of the file", path);
+            dtl::destroy_file_view(file);
+            return std::nullopt;
+        }
+        crd_unlikely_if(header.srgb != (format == texture_srgb)) {
+            spdlog::warn("cooked texture \"{}\" was filtered in a different color space than requested", path);
+        }
+        const auto first = mips.front().offset;
+        const auto bytes = mips.back().offset + mips.back().size - first;
+        spdlog::info("StaticTexture was asynchronously requested, expected bytes to transfer: {}", bytes);
+        Image::CreateInfo info = {
+            .width = header.width,
+            .height = header.height,
+            .mips = header.mips,
+            .layers = 1,
+            .format = cooked_format(header.codec, format),
+            .aspect = VK_IMAGE_ASPECT_COLOR_BIT,
+            .samples = VK_SAMPLE_COUNT_1_BIT,
+            .usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+                     VK_IMAGE_USAGE_SAMPLED_BIT
+        };
+        crd_unlikely_if(load == texture_load_streamed) {
+            TextureSource source = {};
+            source.file = file;
+            source.data = data;
+            for (const auto& mip : mips) {
+                source.offsets.emplace_back(mip.offset);
+            }
+            source.offsets.emplace_back(first + bytes);
+            source.width = header.width;
+            source.height = header.height;
+            return stream_texture(context, std::move(info), std::move(source));
+        }
+        auto image = make_image(context, std::move(info));
+        // Mip offsets are 16 byte aligned in the file, copying them as one range keeps them aligned in staging.
+        const auto staging = context.staging->allocate(context, bytes);
+        std::memcpy(staging.mapped, data + first, bytes);
+        dtl::destroy_file_view(file);
+
+        std::vector<std::size_t> offsets;
+        for (const auto& mip : mips) {
+            offsets.emplace_back(mip.offset - first);
+        }
+        upload_mips(context, image, staging, offsets);
+        context.staging->release(staging);
+        return { image, nullptr, nullptr, nullptr, bindless_null_slot };
+    }
+
+    crd_nodiscard crd_module Async<StaticTexture> request_static_texture(Renderer& renderer, std::string&& path, TextureFormat format, TextureLoad load) noexcept {
         crd_profile_scoped();
         using task_type = std::packaged_task<StaticTexture(ftl::TaskScheduler*)>;
         const auto* context = renderer.context;
-        auto task = new task_type([context, &renderer, path = std::move(path), format](ftl::TaskScheduler* scheduler) noexcept -> StaticTexture {
+        auto task = new task_type([context, &renderer, path = std::move(path), format, load](ftl::TaskScheduler*) noexcept -> StaticTexture {
             crd_profile_scoped();
-            const auto thread_index = scheduler->GetCurrentThreadIndex();
-            const auto graphics_pool = context->graphics->transient[thread_index];
-            const auto transfer_pool = context->transfer->transient[thread_index];
-            std::int32_t width, height, channels = 4;
-            auto file = dtl::make_file_view(path.c_str());
-            auto image_data = stbi_load_from_memory(static_cast<const std::uint8_t*>(file.data), file.size, &width, &height, &channels, STBI_rgb_alpha);
-            if (!image_data) {
-                spdlog::info("error loading texture: {}", path);
+            // A cooked container next to the source (same name, .crdt extension) wins unless it is broken.
+            const auto cooked = fs::path(path).replace_extension(".crdt");
+            std::optional<StaticTexture> loaded;
+            crd_likely_if(dtl::file_exists(cooked.generic_string().c_str())) {
+                loaded = load_cooked_texture(*context, cooked.generic_string(), format, load);
             }
-            spdlog::info("StaticTexture was asynchronously requested, expected bytes to transfer: {}", file.size);
-            dtl::destroy_file_view(file);
-            auto image = make_image(*context, {
-                .width = (std::uint32_t)width,
-                .height = (std::uint32_t)height,
-                .mips = (std::uint32_t)std::floor(std::log2(std::max(width, height))) + 1,
-                .layers = 1,
-                .format = static_cast<VkFormat>(format),
-                .aspect = VK_IMAGE_ASPECT_COLOR_BIT,
-                .samples = VK_SAMPLE_COUNT_1_BIT,
-                .usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT |
-                         VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
-                         VK_IMAGE_USAGE_SAMPLED_BIT
-            });
-            auto staging = make_static_buffer(*context, {
-                .flags = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                .usage = VMA_MEMORY_USAGE_CPU_ONLY,
-                .capacity = (std::size_t)width * height * 4
-            });
-            std::memcpy(staging.mapped, image_data, staging.capacity);
-            stbi_image_free(image_data);
-
-            auto transfer_cmd = make_command_buffer(*context, {
-                .pool = transfer_pool,
-                .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY
-            });
-            transfer_cmd
-                .begin()
-                .transition_layout({
-                    .image = &image,
-                    .mip = 0,
-                    .source_stage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-                    .dest_stage = VK_PIPELINE_STAGE_TRANSFER_BIT,
-                    .source_access = {},
-                    .dest_access = VK_ACCESS_TRANSFER_WRITE_BIT,
-                    .old_layout = VK_IMAGE_LAYOUT_UNDEFINED,
-                    .new_layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
-                })
-                .copy_buffer_to_image(staging, image)
-                .transfer_ownership({
-                    .image = &image,
-                    .mip = 0,
-                    .level = 0,
-                    .source_stage = VK_PIPELINE_STAGE_TRANSFER_BIT,
-                    .dest_stage = VK_PIPELINE_STAGE_TRANSFER_BIT,
-                    .source_access = VK_ACCESS_TRANSFER_WRITE_BIT,
-                    .dest_access = {},
-                    .old_layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                    .new_layout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
-                }, *context->transfer, *context->graphics)
-                .end();
-
-            VkSemaphoreCreateInfo semaphore_info;
-            semaphore_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
-            semaphore_info.pNext = nullptr;
-            semaphore_info.flags = {};
-            VkSemaphore transfer_done;
-            crd_vulkan_check(vkCreateSemaphore(context->device, &semaphore_info, nullptr, &transfer_done));
-            context->transfer->submit({
-                .commands = transfer_cmd,
-                .stages = {},
-                .waits = {},
-                .signals = { transfer_done },
-                .done = {}
-            });
-            auto ownership_cmd = make_command_buffer(*context, {
-                .pool = graphics_pool,
-                .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY
+            auto texture = loaded ? *loaded : load_source_texture(*context, path, format, load);
+            texture.sampler = renderer.acquire_sampler({
+                .filter = VK_FILTER_LINEAR,
+                .border_color = VK_BORDER_COLOR_FLOAT_OPAQUE_BLACK,
+                .address_mode = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+                .anisotropy = 16,
             });
-            ownership_cmd
-                .begin()
-                .transfer_ownership({
-                    .image = &image,
-                    .mip = 0,
-                    .level = 0,
-                    .source_stage = VK_PIPELINE_STAGE_TRANSFER_BIT,
-                    .dest_stage = VK_PIPELINE_STAGE_TRANSFER_BIT,
-                    .source_access = {},
-                    .dest_access = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT,
-                    .old_layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                    .new_layout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
-                }, *context->transfer, *context->graphics);
-            for (std::uint32_t mip = 1; mip < image.mips; ++mip) {
-                ownership_cmd
-                    .transition_layout({
-                        .image = &image,
-                        .mip = mip,
-                        .level = 1,
-                        .source_stage = VK_PIPELINE_STAGE_TRANSFER_BIT,
-                        .dest_stage = VK_PIPELINE_STAGE_TRANSFER_BIT,
-                        .source_access = {},
-                        .dest_access = VK_ACCESS_TRANSFER_WRITE_BIT,
-                        .old_layout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                        .new_layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
-                    })
-                    .blit_image({
-                        .source_image = &image,
-                        .dest_image = nullptr,
-                        .source_off = {
-                            (std::int32_t)image.width >> (mip - 1),
-                            (std::int32_t)image.height >> (mip - 1),
-                            1
-                        },
-                        .dest_off = {
-                            (std::int32_t)image.width >> mip,
-                            (std::int32_t)image.height >> mip,
-                            1
-                        },
-                        .source_mip = mip - 1,
-                        .dest_mip = mip
-                    });
-                if (mip != image.mips - 1) {
-                    ownership_cmd.transition_layout({
-                        .image = &image,
-                        .mip = mip,
-                        .level = 1,
-                        .source_stage = VK_PIPELINE_STAGE_TRANSFER_BIT,
-                        .dest_stage = VK_PIPELINE_STAGE_TRANSFER_BIT,
-                        .source_access = VK_ACCESS_TRANSFER_WRITE_BIT,
-                        .dest_access = VK_ACCESS_TRANSFER_READ_BIT,
-                        .old_layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                        .new_layout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
-                    });
+            // Streamed textures have the streamer queue a write to their slot whenever their view changes.
+            crd_likely_if(renderer.bindless) {
+                texture.bindless = renderer.bindless;
+                crd_unlikely_if(texture.residency) {
+                    texture.slot = context->streamer->publish(texture.residency, texture.bindless, texture.sampler);
                 } else {
-                    ownership_cmd.transition_layout({
-                        .image = &image,
-                        .mip = mip,
-                        .level = 1,
-                        .source_stage = VK_PIPELINE_STAGE_TRANSFER_BIT,
-                        .dest_stage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-                        .source_access = VK_ACCESS_TRANSFER_WRITE_BIT,
-                        .dest_access = VK_ACCESS_SHADER_READ_BIT,
-                        .old_layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                        .new_layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
-                    });
+                    texture.slot = texture.bindless->allocate(texture.image.sample(texture.sampler));
                 }
             }
-            VkPipelineStageFlags final_stage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-#if defined(crd_enable_raytracing)
-            final_stage |= VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR;
-#endif
-            ownership_cmd
-                .transition_layout({
-                    .image = &image,
-                    .mip = 0,
-                    .level = std::max(image.mips - 1, 1u),
-                    .source_stage = VK_PIPELINE_STAGE_TRANSFER_BIT,
-                    .dest_stage = final_stage,
-                    .source_access = VK_ACCESS_TRANSFER_READ_BIT,
-                    .dest_access = VK_ACCESS_SHADER_READ_BIT,
-                    .old_layout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                    .new_layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
-                })
-                .end();
-            VkFenceCreateInfo done_fence_info;
-            done_fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-            done_fence_info.pNext = nullptr;
-            done_fence_info.flags = {};
-            VkFence request_done;
-            crd_vulkan_check(vkCreateFence(context->device, &done_fence_info, nullptr, &request_done));
-            context->graphics->submit({
-                .commands = ownership_cmd,
-                .stages = { VK_PIPELINE_STAGE_TRANSFER_BIT },
-                .waits = { transfer_done },
-                .signals = {},
-                .done = request_done
-            });
-            wait_fence(*context, request_done);
-            vkDestroySemaphore(context->device, transfer_done, nullptr);
-            vkDestroyFence(context->device, request_done, nullptr);
-            staging.destroy();
-            destroy_command_buffer(*context, ownership_cmd);
-            destroy_command_buffer(*context, transfer_cmd);
-            return {
-                image, renderer.acquire_sampler({
-                    .filter = VK_FILTER_LINEAR,
-                    .border_color = VK_BORDER_COLOR_FLOAT_OPAQUE_BLACK,
-                    .address_mode = VK_SAMPLER_ADDRESS_MODE_REPEAT,
-                    .anisotropy = 16,
-                })
-            };
+            return texture;
         });
         auto future = task->get_future();
         context->scheduler->AddTask({
@@ -235,12 +265,43 @@ namespace crd {
 
     crd_nodiscard crd_module VkDescriptorImageInfo StaticTexture::info() const noexcept {
         crd_profile_scoped();
-        return image.sample(sampler);
+        crd_likely_if(!residency) {
+            return image.sample(sampler);
+        }
+        mark_used();
+        return {
+            .sampler = sampler,
+            .imageView = residency->view.load(std::memory_order_acquire),
+            .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+        };
+    }
+
+    crd_nodiscard crd_module std::uint32_t StaticTexture::bindless_slot() const noexcept {
+        crd_profile_scoped();
+        mark_used();
+        return slot;
+    }
+
+    crd_module void StaticTexture::mark_used() const noexcept {
+        crd_profile_scoped();
+        crd_likely_if(!residency) {
+            return;
+        }
+        // The least recently used textures lose their top levels first.
+        residency->last_used.store(residency->context->streamer->frame.load(std::memory_order_relaxed), std::memory_order_relaxed);
     }
 
     crd_module void StaticTexture::destroy() noexcept {
         crd_profile_scoped();
-        image.destroy();
+        // A streamed texture's slot is released along with its residency.
+        crd_unlikely_if(residency) {
+            destroy_texture_residency(residency);
+        } else {
+            crd_likely_if(bindless) {
+                bindless->release(slot);
+            }
+            image.destroy();
+        }
         *this = {};
     }
 } // namespace crd
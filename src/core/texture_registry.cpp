@@ -0,0 +1,69 @@
+#include <corundum/core/texture_registry.hpp>
+#include <corundum/core/async.hpp>
+
+#if defined(crd_enable_profiling)
+    #include <Tracy.hpp>
+#endif
+
+#include <spdlog/spdlog.h>
+
+#include <filesystem>
+#include <vector>
+
+namespace crd {
+    namespace fs = std::filesystem;
+
+    crd_nodiscard crd_module Async<StaticTexture>* TextureRegistry::acquire(Renderer& renderer, std::string&& path, TextureFormat format, TextureLoad load) noexcept {
+        crd_profile_scoped();
+        // Lexical only, so keying a texture costs no file system calls (and works for archived paths).
+        std::error_code error;
+        auto canonical = fs::absolute(path, error).lexically_normal();
+        auto key = canonical.generic_string();
+        key += format == texture_srgb ? "#srgb" : "#unorm";
+        std::lock_guard<std::mutex> guard(lock);
+        const auto [entry, miss] = entries.try_emplace(std::move(key));
+        crd_unlikely_if(miss) {
+            entry->second.texture = new Async<StaticTexture>(request_static_texture(renderer, canonical.generic_string(), format, load));
+            entry->second.references = 0;
+            keys.emplace(entry->second.texture, entry->first);
+        }
+        entry->second.references++;
+        return entry->second.texture;
+    }
+
+    crd_module void TextureRegistry::release(Async<StaticTexture>* texture) noexcept {
+        crd_profile_scoped();
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            const auto key = keys.find(texture);
+            crd_assert(key != keys.end(), "texture was not acquired from this registry");
+            const auto entry = entries.find(key->second);
+            crd_likely_if(--entry->second.references > 0) {
+                return;
+            }
+            entries.erase(entry);
+            keys.erase(key);
+        }
+        // Outside of the lock, waiting on a texture which is still loading must not hold up other requests.
+        (*texture)->destroy();
+        delete texture;
+    }
+
+    crd_nodiscard crd_module TextureRegistry* make_texture_registry() noexcept {
+        crd_profile_scoped();
+        return new TextureRegistry();
+    }
+
+    crd_module void destroy_texture_registry(TextureRegistry*& registry) noexcept {
+        crd_profile_scoped();
+        crd_unlikely_if(!registry->entries.empty()) {
+            spdlog::warn("{} textures were still referenced when the registry was destroyed", registry->entries.size());
+        }
+        for (auto& [_, entry] : registry->entries) {
+            (*entry.texture)->destroy();
+            delete entry.texture;
+        }
+        delete registry;
+        registry = nullptr;
+    }
+} // namespace crd
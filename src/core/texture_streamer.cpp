@@ -0,0 +1,430 @@
+#include <corundum/core/texture_streamer.hpp>
+#include <corundum/core/upload_batcher.hpp>
+#include <corundum/core/command_buffer.hpp>
+#include <corundum/core/staging_ring.hpp>
+#include <corundum/core/bindless.hpp>
+#include <corundum/core/context.hpp>
+#include <corundum/core/queue.hpp>
+
+#if defined(crd_enable_profiling)
+    #include <Tracy.hpp>
+#endif
+
+#include <spdlog/spdlog.h>
+
+#include <ftl/task_scheduler.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace crd {
+    // Reallocations started per frame while over budget.
+    constexpr auto max_evictions = 4u;
+    // Reallocations started per frame to give evicted textures their full chain back.
+    constexpr auto max_promotions = 1u;
+    // Textures only grow back while this fraction of the budget stays free, so that they do not thrash.
+    constexpr auto promotion_headroom = 8u;
+
+    crd_nodiscard static inline std::vector<VkImageView> make_views(const Context& context, const Image& image) noexcept {
+        crd_profile_scoped();
+        std::vector<VkImageView> views(image.mips);
+        views[0] = image.view;
+        for (std::uint32_t mip = 1; mip < image.mips; ++mip) {
+            VkImageViewCreateInfo image_view_info;
+            image_view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+            image_view_info.pNext = nullptr;
+            image_view_info.flags = {};
+            image_view_info.image = image.handle;
+            image_view_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+            image_view_info.format = image.format;
+            image_view_info.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
+            image_view_info.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
+            image_view_info.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
+            image_view_info.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
+            image_view_info.subresourceRange.aspectMask = image.aspect;
+            image_view_info.subresourceRange.baseMipLevel = mip;
+            image_view_info.subresourceRange.levelCount = image.mips - mip;
+            image_view_info.subresourceRange.baseArrayLayer = 0;
+            image_view_info.subresourceRange.layerCount = 1;
+            crd_vulkan_check(vkCreateImageView(context.device, &image_view_info, nullptr, &views[mip]));
+        }
+        return views;
+    }
+
+    // views[0] belongs to the image itself.
+    static inline void destroy_views(Image& image, std::vector<VkImageView>& views) noexcept {
+        crd_profile_scoped();
+        for (std::size_t mip = 1; mip < views.size(); ++mip) {
+            vkDestroyImageView(image.context->device, views[mip], nullptr);
+        }
+        views.clear();
+        image.destroy();
+    }
+
+    crd_nodiscard static inline std::size_t level_bytes(const TextureResidency* residency, std::uint32_t first, std::uint32_t last) noexcept {
+        return residency->source.offsets[last] - residency->source.offsets[first];
+    }
+
+    // Levels to reallocate a texture down to: first the ones not streamed in yet, then the top resident one.
+    crd_nodiscard static inline std::uint32_t drop_target(const TextureResidency* residency) noexcept {
+        const auto target = residency->resident > residency->base ? residency->resident : residency->base + 1;
+        return std::min(target, residency->tail);
+    }
+
+    // Called under the streamer lock once the work dispatched for a texture completed.
+    static inline void finish(TextureStreamer* streamer, TextureResidency* residency) noexcept {
+        crd_profile_scoped();
+        residency->view.store(residency->views[residency->resident - residency->base], std::memory_order_release);
+        // Frames in flight may sample the slot, the table queues the write until they are done with it.
+        crd_likely_if(residency->bindless) {
+            residency->bindless->update(residency->slot, {
+                .sampler = residency->sampler,
+                .imageView = residency->view.load(std::memory_order_relaxed),
+                .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+            });
+        }
+        crd_unlikely_if(residency->cancelled || residency->resident == residency->base) {
+            residency->state = residency_idle;
+        } else {
+            residency->next = residency->resident - 1;
+            residency->state = residency_queued;
+            streamer->pending.emplace_back(residency);
+        }
+        streamer->busy--;
+        streamer->idle.notify_all();
+    }
+
+    // Uploads the next level of a texture into its current allocation.
+    static void stream_level(ftl::TaskScheduler*, void* data) noexcept {
+        crd_profile_scoped();
+        auto residency = static_cast<TextureResidency*>(data);
+        const auto& context = *residency->context;
+        const auto mip = residency->next;
+        const auto size = level_bytes(residency, mip, mip + 1);
+        const auto staging = context.staging->allocate(context, size);
+        std::memcpy(staging.mapped, residency->source.data + residency->source.offsets[mip], size);
+        upload_mips(context, residency->image, staging, { 0 }, mip - residency->base);
+        context.staging->release(staging);
+
+        auto streamer = context.streamer;
+        std::lock_guard<std::mutex> guard(streamer->lock);
+        residency->resident = mip;
+        finish(streamer, residency);
+    }
+
+    // Moves a texture to a new allocation starting at level `next`, uploading whichever of its resident
+    // levels the new allocation holds. The old allocation is retired, descriptors may still point at it.
+    static void reallocate_texture(ftl::TaskScheduler*, void* data) noexcept {
+        crd_profile_scoped();
+        auto residency = static_cast<TextureResidency*>(data);
+        const auto& context = *residency->context;
+        const auto base = residency->next;
+        const auto keep = std::max(base, residency->resident);
+        auto image = make_image(context, {
+            .width = std::max(residency->source.width >> base, 1u),
+            .height = std::max(residency->source.height >> base, 1u),
+            .mips = residency->mips - base,
+            .layers = 1,
+            .format = residency->image.format,
+            .aspect = VK_IMAGE_ASPECT_COLOR_BIT,
+            .samples = VK_SAMPLE_COUNT_1_BIT,
+            .usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+                     VK_IMAGE_USAGE_SAMPLED_BIT
+        });
+        auto views = make_views(context, image);
+        const auto& offsets = residency->source.offsets;
+        const auto bytes = level_bytes(residency, keep, residency->mips);
+        const auto staging = context.staging->allocate(context, bytes);
+        std::memcpy(staging.mapped, residency->source.data + offsets[keep], bytes);
+        std::vector<std::size_t> staged;
+        for (auto mip = keep; mip < residency->mips; ++mip) {
+            staged.emplace_back(offsets[mip] - offsets[keep]);
+        }
+        upload_mips(context, image, staging, staged, keep - base);
+        context.staging->release(staging);
+        spdlog::debug("texture reallocated from level {} to level {}, {} levels resident", residency->base, base, residency->mips - keep);
+
+        auto streamer = context.streamer;
+        std::lock_guard<std::mutex> guard(streamer->lock);
+        streamer->retired.push_back({ residency->image, std::move(residency->views), streamer->frame.load() });
+        residency->image = image;
+        residency->views = std::move(views);
+        residency->base = base;
+        residency->resident = keep;
+        finish(streamer, residency);
+    }
+
+    static inline void heap_usage(VmaAllocator allocator, std::size_t& usage, std::size_t& available) noexcept {
+        crd_profile_scoped();
+        const VkPhysicalDeviceMemoryProperties* memory;
+        vmaGetMemoryProperties(allocator, &memory);
+        VmaBudget budgets[VK_MAX_MEMORY_HEAPS];
+        vmaGetHeapBudgets(allocator, budgets);
+        usage = 0;
+        available = 0;
+        for (std::uint32_t heap = 0; heap < memory->memoryHeapCount; ++heap) {
+            crd_likely_if(memory->memoryHeaps[heap].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) {
+                usage += budgets[heap].usage;
+                available += budgets[heap].budget;
+            }
+        }
+    }
+
+    crd_nodiscard crd_module bool TextureStreamer::has_room(std::size_t bytes) const noexcept {
+        crd_profile_scoped();
+        std::size_t usage, available;
+        heap_usage(allocator, usage, available);
+        const auto limit = memory_budget != 0 ? memory_budget : available;
+        return usage + bytes <= limit;
+    }
+
+    crd_module void TextureStreamer::track(TextureResidency* residency) noexcept {
+        crd_profile_scoped();
+        std::lock_guard<std::mutex> guard(lock);
+        textures.emplace_back(residency);
+        residency->last_used = frame.load();
+        crd_likely_if(residency->resident > residency->base) {
+            residency->next = residency->resident - 1;
+            residency->state = residency_queued;
+            pending.emplace_back(residency);
+        }
+    }
+
+    crd_module void TextureStreamer::begin_frame() noexcept {
+        crd_profile_scoped();
+        std::lock_guard<std::mutex> guard(lock);
+        const auto current = ++frame;
+        std::erase_if(retired, [current](Retired& each) noexcept {
+            crd_unlikely_if(current > each.frame + in_flight) {
+                destroy_views(each.image, each.views);
+                return true;
+            }
+            return false;
+        });
+
+        std::size_t usage, available;
+        heap_usage(allocator, usage, available);
+        const auto limit = memory_budget != 0 ? memory_budget : available;
+        auto bytes = frame_budget;
+        const auto dispatch = [&](TextureResidency* residency, void(*function)(ftl::TaskScheduler*, void*), std::size_t size) noexcept {
+            bytes -= std::min(size, bytes);
+            residency->state = residency_busy;
+            busy++;
+            scheduler->AddTask({
+                .Function = function,
+                .ArgData = residency
+            }, ftl::TaskPriority::Normal);
+        };
+
+        std::vector<TextureResidency*> candidates;
+        crd_unlikely_if(usage > limit) {
+            for (auto residency : textures) {
+                crd_likely_if(residency->state != residency_busy && drop_target(residency) > residency->base) {
+                    candidates.emplace_back(residency);
+                }
+            }
+            std::sort(candidates.begin(), candidates.end(), [](const TextureResidency* left, const TextureResidency* right) noexcept {
+                return left->last_used < right->last_used;
+            });
+            auto excess = usage - limit;
+            std::uint32_t evicted = 0;
+            for (auto residency : candidates) {
+                crd_unlikely_if(excess == 0 || evicted == max_evictions) {
+                    break;
+                }
+                crd_unlikely_if(residency->state == residency_queued) {
+                    pending.erase(std::find(pending.begin(), pending.end(), residency));
+                }
+                residency->next = drop_target(residency);
+                excess -= std::min(excess, level_bytes(residency, residency->base, residency->next));
+                dispatch(residency, reallocate_texture, level_bytes(residency, residency->next, residency->mips));
+                evicted++;
+            }
+            spdlog::debug("texture memory over budget: {} of {} bytes, reallocating {} textures", usage, limit, evicted);
+        } else {
+            for (auto residency : textures) {
+                crd_unlikely_if(residency->state == residency_idle && residency->base > 0 && residency->last_used + in_flight >= current) {
+                    candidates.emplace_back(residency);
+                }
+            }
+            std::sort(candidates.begin(), candidates.end(), [](const TextureResidency* left, const TextureResidency* right) noexcept {
+                return left->last_used > right->last_used;
+            });
+            auto room = limit - usage;
+            room -= std::min(room, limit / promotion_headroom);
+            std::uint32_t promoted = 0;
+            for (auto residency : candidates) {
+                const auto growth = level_bytes(residency, 0, residency->base);
+                crd_unlikely_if(growth > room || promoted == max_promotions) {
+                    break;
+                }
+                room -= growth;
+                residency->next = 0;
+                dispatch(residency, reallocate_texture, level_bytes(residency, residency->resident, residency->mips));
+                promoted++;
+            }
+        }
+
+        while (!pending.empty()) {
+            auto residency = pending.front();
+            const auto size = level_bytes(residency, residency->next, residency->next + 1);
+            crd_unlikely_if(size > bytes && bytes != frame_budget) {
+                break;
+            }
+            pending.pop_front();
+            dispatch(residency, stream_level, size);
+        }
+    }
+
+    crd_nodiscard crd_module std::uint32_t TextureStreamer::publish(TextureResidency* residency, BindlessTable* bindless, VkSampler sampler) noexcept {
+        crd_profile_scoped();
+        // Under the lock, so that a level landing concurrently cannot write an older view after this one.
+        std::lock_guard<std::mutex> guard(lock);
+        residency->bindless = bindless;
+        residency->sampler = sampler;
+        residency->slot = bindless->allocate({
+            .sampler = sampler,
+            .imageView = residency->view.load(std::memory_order_relaxed),
+            .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+        });
+        return residency->slot;
+    }
+
+    crd_module void TextureStreamer::release(TextureResidency* residency) noexcept {
+        crd_profile_scoped();
+        std::unique_lock<std::mutex> guard(lock);
+        crd_unlikely_if(residency->state == residency_queued) {
+            pending.erase(std::find(pending.begin(), pending.end(), residency));
+            residency->state = residency_idle;
+        }
+        std::erase(textures, residency);
+        residency->cancelled = true;
+        idle.wait(guard, [residency]() noexcept {
+            return residency->state != residency_busy;
+        });
+    }
+
+    crd_nodiscard crd_module TextureStreamer* make_texture_streamer(const Context& context, std::size_t frame_budget, std::size_t memory_budget) noexcept {
+        crd_profile_scoped();
+        auto streamer = new TextureStreamer();
+        streamer->allocator = context.allocator;
+        streamer->scheduler = context.scheduler;
+        streamer->frame = 0;
+        streamer->frame_budget = frame_budget;
+        streamer->memory_budget = memory_budget;
+        streamer->busy = 0;
+        return streamer;
+    }
+
+    crd_module void destroy_texture_streamer(TextureStreamer*& streamer) noexcept {
+        crd_profile_scoped();
+        {
+            std::unique_lock<std::mutex> guard(streamer->lock);
+            for (auto residency : streamer->textures) {
+                residency->cancelled = true;
+            }
+            streamer->idle.wait(guard, [streamer]() noexcept {
+                return streamer->busy == 0;
+            });
+            for (auto& each : streamer->retired) {
+                destroy_views(each.image, each.views);
+            }
+        }
+        delete streamer;
+        streamer = nullptr;
+    }
+
+    crd_nodiscard crd_module TextureResidency* make_texture_residency(const Context& context, const Image& image, TextureSource&& source, std::uint32_t base, std::uint32_t resident) noexcept {
+        crd_profile_scoped();
+        auto residency = new TextureResidency();
+        residency->context = &context;
+        residency->source = std::move(source);
+        residency->image = image;
+        residency->views = make_views(context, image);
+        residency->mips = base + image.mips;
+        residency->base = base;
+        residency->tail = resident;
+        residency->resident = resident;
+        residency->next = 0;
+        residency->bindless = nullptr;
+        residency->slot = 0;
+        residency->sampler = nullptr;
+        residency->state = residency_idle;
+        residency->cancelled = false;
+        residency->view = residency->views[resident - base];
+        return residency;
+    }
+
+    crd_module void destroy_texture_residency(TextureResidency*& residency) noexcept {
+        crd_profile_scoped();
+        residency->context->streamer->release(residency);
+        // No level lands anymore, the slot goes before the views its queued writes name.
+        crd_likely_if(residency->bindless) {
+            residency->bindless->release(residency->slot);
+        }
+        destroy_views(residency->image, residency->views);
+        crd_likely_if(residency->source.file.data) {
+            dtl::destroy_file_view(residency->source.file);
+        }
+        delete residency;
+        residency = nullptr;
+    }
+
+    crd_module void upload_mips(const Context& context, const Image& image, const StagingBlock& staging, const std::vector<std::size_t>& offsets, std::uint32_t first) noexcept {
+        crd_profile_scoped();
+        VkPipelineStageFlags final_stage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+#if defined(crd_enable_raytracing)
+        final_stage |= VK_PIPELINE_STAGE_RAY_TRACING_SHADER_BIT_KHR;
+#endif
+        const auto levels = (std::uint32_t)offsets.size();
+        await_upload(context, {
+            .transfer = [&](CommandBuffer& commands) noexcept {
+                commands.transition_layout({
+                    .image = &image,
+                    .mip = first,
+                    .level = levels,
+                    .source_stage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                    .dest_stage = VK_PIPELINE_STAGE_TRANSFER_BIT,
+                    .source_access = {},
+                    .dest_access = VK_ACCESS_TRANSFER_WRITE_BIT,
+                    .old_layout = VK_IMAGE_LAYOUT_UNDEFINED,
+                    .new_layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
+                });
+                for (std::uint32_t level = 0; level < levels; ++level) {
+                    commands.copy_buffer_to_image({
+                        .source = staging.buffer,
+                        .dest = &image,
+                        .source_offset = staging.offset + offsets[level],
+                        .mip = first + level
+                    });
+                }
+                commands.transfer_ownership({
+                    .image = &image,
+                    .mip = first,
+                    .level = levels,
+                    .source_stage = VK_PIPELINE_STAGE_TRANSFER_BIT,
+                    .dest_stage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                    .source_access = VK_ACCESS_TRANSFER_WRITE_BIT,
+                    .dest_access = {},
+                    .old_layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    .new_layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+                }, *context.transfer, *context.graphics);
+            },
+            .acquire = [&](CommandBuffer& commands) noexcept {
+                commands.transfer_ownership({
+                    .image = &image,
+                    .mip = first,
+                    .level = levels,
+                    .source_stage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                    .dest_stage = final_stage,
+                    .source_access = {},
+                    .dest_access = VK_ACCESS_SHADER_READ_BIT,
+                    .old_layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    .new_layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+                }, *context.transfer, *context.graphics);
+            },
+            .bytes = staging.size,
+            .waiter = nullptr
+        });
+    }
+} // namespace crd
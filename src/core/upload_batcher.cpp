@@ -0,0 +1,149 @@
+#include <corundum/core/upload_batcher.hpp>
+#include <corundum/core/context.hpp>
+#include <corundum/core/queue.hpp>
+
+#if defined(crd_enable_profiling)
+    #include <Tracy.hpp>
+#endif
+
+#include <spdlog/spdlog.h>
+
+#include <ftl/wait_group.h>
+
+#include <chrono>
+
+namespace crd {
+    // How long the first request of a batch waits for others to join it.
+    constexpr auto upload_batch_window = std::chrono::milliseconds(2);
+    // Flushes early once this many bytes are queued.
+    constexpr auto upload_batch_budget = 32ull * 1024 * 1024;
+
+    static inline void flush_uploads(UploadBatcher* batcher) noexcept {
+        crd_profile_scoped();
+        std::vector<UploadJob> batch;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> guard(batcher->lock);
+                batcher->wake.wait(guard, [batcher]() noexcept {
+                    return !batcher->running || !batcher->pending.empty();
+                });
+                crd_unlikely_if(!batcher->running && batcher->pending.empty()) {
+                    return;
+                }
+                batcher->wake.wait_for(guard, upload_batch_window, [batcher]() noexcept {
+                    return !batcher->running || batcher->pending_bytes >= upload_batch_budget;
+                });
+                batch.swap(batcher->pending);
+                batcher->pending_bytes = 0;
+            }
+            batcher->transfer_cmd.begin();
+            for (auto& job : batch) {
+                job.transfer(batcher->transfer_cmd);
+            }
+            batcher->transfer_cmd.end();
+            batcher->acquire_cmd.begin();
+            for (auto& job : batch) {
+                crd_likely_if(job.acquire) {
+                    job.acquire(batcher->acquire_cmd);
+                }
+            }
+            batcher->acquire_cmd.end();
+            const auto transfer_ticket = batcher->transfer->submit({
+                .commands = batcher->transfer_cmd,
+                .stages = {},
+                .waits = {},
+                .signals = {},
+                .tickets = {}
+            });
+            const auto graphics_ticket = batcher->graphics->submit({
+                .commands = batcher->acquire_cmd,
+                .stages = {},
+                .waits = {},
+                .signals = {},
+                .tickets = { { batcher->transfer, transfer_ticket, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT } }
+            });
+            VkSemaphoreWaitInfo wait_info;
+            wait_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+            wait_info.pNext = nullptr;
+            wait_info.flags = {};
+            wait_info.semaphoreCount = 1;
+            wait_info.pSemaphores = &batcher->graphics->timeline;
+            wait_info.pValues = &graphics_ticket;
+            crd_vulkan_check(vkWaitSemaphores(batcher->device, &wait_info, -1));
+            spdlog::debug("upload batch completed, requests: {}", batch.size());
+            {
+                // Signaled under the batcher lock, see await_upload.
+                std::lock_guard<std::mutex> guard(batcher->lock);
+                for (const auto& job : batch) {
+                    job.waiter->Done();
+                }
+            }
+            batch.clear();
+        }
+    }
+
+    crd_nodiscard crd_module UploadBatcher* make_upload_batcher(const Context& context) noexcept {
+        crd_profile_scoped();
+        auto batcher = new UploadBatcher();
+        batcher->device = context.device;
+        batcher->transfer = context.transfer;
+        batcher->graphics = context.graphics;
+        VkCommandPoolCreateInfo command_pool_info;
+        command_pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        command_pool_info.pNext = nullptr;
+        command_pool_info.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        command_pool_info.queueFamilyIndex = context.transfer->family;
+        crd_vulkan_check(vkCreateCommandPool(context.device, &command_pool_info, nullptr, &batcher->transfer_pool));
+        command_pool_info.queueFamilyIndex = context.graphics->family;
+        crd_vulkan_check(vkCreateCommandPool(context.device, &command_pool_info, nullptr, &batcher->graphics_pool));
+        batcher->transfer_cmd = make_command_buffer(context, {
+            .pool = batcher->transfer_pool,
+            .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY
+        });
+        batcher->acquire_cmd = make_command_buffer(context, {
+            .pool = batcher->graphics_pool,
+            .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY
+        });
+        batcher->pending_bytes = 0;
+        batcher->running = true;
+        batcher->flusher = std::thread(flush_uploads, batcher);
+        return batcher;
+    }
+
+    crd_module void destroy_upload_batcher(const Context& context, UploadBatcher*& batcher) noexcept {
+        crd_profile_scoped();
+        {
+            std::lock_guard<std::mutex> guard(batcher->lock);
+            batcher->running = false;
+        }
+        batcher->wake.notify_one();
+        batcher->flusher.join();
+        destroy_command_buffer(context, batcher->acquire_cmd);
+        destroy_command_buffer(context, batcher->transfer_cmd);
+        vkDestroyCommandPool(context.device, batcher->graphics_pool, nullptr);
+        vkDestroyCommandPool(context.device, batcher->transfer_pool, nullptr);
+        delete batcher;
+        batcher = nullptr;
+    }
+
+    crd_module void UploadBatcher::enqueue(UploadJob&& job) noexcept {
+        crd_profile_scoped();
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            pending_bytes += job.bytes;
+            pending.emplace_back(std::move(job));
+        }
+        wake.notify_one();
+    }
+
+    crd_module void await_upload(const Context& context, UploadJob&& job) noexcept {
+        crd_profile_scoped();
+        ftl::WaitGroup waiter(context.scheduler);
+        waiter.Add(1);
+        job.waiter = &waiter;
+        context.uploads->enqueue(std::move(job));
+        waiter.Wait(true);
+        // The flusher may still be inside Done() when we resume, it releases the lock only once it's out.
+        std::lock_guard<std::mutex> guard(context.uploads->lock);
+    }
+} // namespace crd
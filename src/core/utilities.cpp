@@ -1,4 +1,5 @@
 #include <corundum/core/acceleration_structure.hpp>
+#include <corundum/core/geometry_arena.hpp>
 #include <corundum/core/static_buffer.hpp>
 #include <corundum/core/utilities.hpp>
 #include <corundum/core/dispatch.hpp>
@@ -39,6 +40,12 @@ namespace crd {
         return device_address(context, buffer.handle);
     }
 
+    template <>
+    crd_nodiscard crd_module VkDeviceAddress device_address(const Context&, const GeometryRange& range) noexcept {
+        crd_profile_scoped();
+        return range.block->buffer.address + range.offset;
+    }
+
     template <>
     crd_nodiscard crd_module VkDeviceAddress device_address(const Context& context, const TopLevelAS& as) noexcept {
         crd_profile_scoped();
@@ -0,0 +1,261 @@
+#include <corundum/detail/archive.hpp>
+#include <corundum/detail/lz4.hpp>
+
+#if defined(crd_enable_profiling)
+    #include <Tracy.hpp>
+#endif
+
+#include <spdlog/spdlog.h>
+
+#include <ftl/task_scheduler.h>
+#include <ftl/wait_group.h>
+
+#include <filesystem>
+#include <algorithm>
+#include <cstring>
+#include <atomic>
+
+namespace fs = std::filesystem;
+
+namespace crd::dtl {
+    static std::atomic<Archive*> mounted = nullptr;
+
+    struct BlockJob {
+        const std::uint8_t* source;
+        std::uint32_t compressed;
+        std::uint8_t* dest;
+        std::size_t size;
+        bool extracted;
+    };
+
+    crd_nodiscard static inline bool extract_block(const BlockJob& job) noexcept {
+        crd_profile_scoped();
+        crd_unlikely_if(job.compressed & archive_block_stored) {
+            std::memcpy(job.dest, job.source, job.size);
+            return true;
+        }
+        return lz4_decompress(job.source, job.compressed, job.dest, job.size);
+    }
+
+    // Every table, path and block range must lie within the mapping, nothing read from a .crdp is trusted before that.
+    crd_nodiscard static inline bool is_valid_archive(const ArchiveHeader& header, const std::uint8_t* data, std::size_t size) noexcept {
+        crd_profile_scoped();
+        crd_unlikely_if(header.block_size != archive_block_size) {
+            return false;
+        }
+        auto tables = size - sizeof(header);
+        crd_unlikely_if(header.entries > tables / sizeof(ArchiveEntry)) {
+            return false;
+        }
+        tables -= header.entries * sizeof(ArchiveEntry);
+        crd_unlikely_if(header.blocks > tables / sizeof(std::uint32_t)) {
+            return false;
+        }
+        tables -= header.blocks * sizeof(std::uint32_t);
+        crd_unlikely_if(header.strings_size > tables) {
+            return false;
+        }
+        const auto entries = reinterpret_cast<const ArchiveEntry*>(data + sizeof(header));
+        const auto blocks = reinterpret_cast<const std::uint32_t*>(entries + header.entries);
+        for (std::uint32_t i = 0; i < header.entries; ++i) {
+            const auto& entry = entries[i];
+            const auto expected = std::max<std::uint64_t>(1, (entry.size + archive_block_size - 1) / archive_block_size);
+            crd_unlikely_if(
+                (std::uint64_t)entry.path_offset + entry.path_size > header.strings_size ||
+                entry.block_count != expected ||
+                entry.size > (std::uint64_t)entry.block_count * archive_block_size ||
+                (std::uint64_t)entry.first_block + entry.block_count > header.blocks ||
+                entry.offset > size) {
+                return false;
+            }
+            auto payload = size - entry.offset;
+            for (std::uint32_t block = 0; block < entry.block_count; ++block) {
+                const auto compressed = blocks[entry.first_block + block];
+                const auto bytes = compressed & ~archive_block_stored;
+                const auto extent = std::min<std::uint64_t>(archive_block_size, entry.size - (std::uint64_t)block * archive_block_size);
+                // A stored block is copied as is, it must hold exactly the bytes it stands for.
+                crd_unlikely_if(bytes > payload || ((compressed & archive_block_stored) && bytes != extent)) {
+                    return false;
+                }
+                payload -= bytes;
+            }
+        }
+        return true;
+    }
+
+    crd_nodiscard Archive* make_archive(const char* path, const char* root, ftl::TaskScheduler* scheduler) noexcept {
+        crd_profile_scoped();
+        std::error_code error;
+        crd_unlikely_if(!fs::exists(path, error)) {
+            return nullptr;
+        }
+        auto file = make_file_view(path);
+        const auto data = static_cast<const std::uint8_t*>(file.data);
+        ArchiveHeader header;
+        crd_unlikely_if(file.size < sizeof(header)) {
+            destroy_file_view(file);
+            return nullptr;
+        }
+        std::memcpy(&header, data, sizeof(header));
+        crd_unlikely_if(header.magic != archive_magic || header.version != archive_version || !is_valid_archive(header, data, file.size)) {
+            spdlog::error("\"{}\" is not a valid archive", path);
+            destroy_file_view(file);
+            return nullptr;
+        }
+        auto archive = new Archive();
+        archive->file = file;
+        archive->scheduler = scheduler;
+        archive->root = fs::absolute(root).lexically_normal().generic_string();
+        archive->working_directory = fs::current_path().generic_string();
+        archive->entries = reinterpret_cast<const ArchiveEntry*>(data + sizeof(header));
+        archive->blocks = reinterpret_cast<const std::uint32_t*>(archive->entries + header.entries);
+        const auto strings = reinterpret_cast<const char*>(archive->blocks + header.blocks);
+        archive->lookup.reserve(header.entries);
+        for (std::uint32_t i = 0; i < header.entries; ++i) {
+            const auto& entry = archive->entries[i];
+            archive->lookup.emplace(std::string_view(strings + entry.path_offset, entry.path_size), &entry);
+        }
+        spdlog::info("archive \"{}\" mapped, entries: {}", path, header.entries);
+        return archive;
+    }
+
+    void destroy_archive(Archive*& archive) noexcept {
+        crd_profile_scoped();
+        crd_unlikely_if(mounted.load(std::memory_order_acquire) == archive) {
+            mount_archive(nullptr);
+        }
+        destroy_file_view(archive->file);
+        delete archive;
+        archive = nullptr;
+    }
+
+    crd_nodiscard const ArchiveEntry* find_entry(const Archive& archive, const char* path) noexcept {
+        crd_profile_scoped();
+        // Purely lexical, resolving a path never touches the file system.
+        auto absolute = fs::path(path);
+        crd_likely_if(absolute.is_relative()) {
+            absolute = fs::path(archive.working_directory) / absolute;
+        }
+        const auto relative = absolute.lexically_normal().lexically_relative(archive.root).generic_string();
+        crd_unlikely_if(relative.empty() || relative.starts_with("..")) {
+            return nullptr;
+        }
+        const auto entry = archive.lookup.find(relative);
+        return entry == archive.lookup.end() ? nullptr : entry->second;
+    }
+
+    crd_nodiscard const std::uint8_t* stored_entry(const Archive& archive, const ArchiveEntry& entry) noexcept {
+        crd_profile_scoped();
+        for (std::uint32_t i = 0; i < entry.block_count; ++i) {
+            crd_likely_if(!(archive.blocks[entry.first_block + i] & archive_block_stored)) {
+                return nullptr;
+            }
+        }
+        return static_cast<const std::uint8_t*>(archive.file.data) + entry.offset;
+    }
+
+    crd_nodiscard bool extract_entry(const Archive& archive, const ArchiveEntry& entry, std::uint8_t* dest) noexcept {
+        crd_profile_scoped();
+        std::vector<BlockJob> jobs(entry.block_count);
+        auto source = static_cast<const std::uint8_t*>(archive.file.data) + entry.offset;
+        for (std::uint32_t i = 0; i < entry.block_count; ++i) {
+            const auto compressed = archive.blocks[entry.first_block + i];
+            auto& job = jobs[i];
+            job.source = source;
+            job.compressed = compressed;
+            job.dest = dest + (std::size_t)i * archive_block_size;
+            job.size = std::min<std::size_t>(archive_block_size, entry.size - (std::size_t)i * archive_block_size);
+            job.extracted = false;
+            source += compressed & ~archive_block_stored;
+        }
+        crd_likely_if(jobs.size() == 1) {
+            return extract_block(jobs.front());
+        }
+        std::vector<ftl::Task> tasks(jobs.size());
+        for (std::size_t i = 0; i < jobs.size(); ++i) {
+            tasks[i] = {
+                .Function = +[](ftl::TaskScheduler*, void* data) {
+                    crd_profile_scoped();
+                    auto& job = *static_cast<BlockJob*>(data);
+                    job.extracted = extract_block(job);
+                },
+                .ArgData = &jobs[i]
+            };
+        }
+        ftl::WaitGroup waiter(archive.scheduler);
+        archive.scheduler->AddTasks(tasks.size(), tasks.data(), ftl::TaskPriority::High, &waiter);
+        waiter.Wait();
+        return std::all_of(jobs.begin(), jobs.end(), [](const BlockJob& job) noexcept {
+            return job.extracted;
+        });
+    }
+
+    crd_nodiscard std::vector<std::uint8_t> pack_archive(const std::vector<std::string>& paths, const std::vector<std::vector<std::uint8_t>>& contents) noexcept {
+        crd_profile_scoped();
+        const auto align = [](std::size_t offset) noexcept {
+            return (offset + 15) & ~(std::size_t)15;
+        };
+        ArchiveHeader header = {};
+        header.magic = archive_magic;
+        header.version = archive_version;
+        header.entries = paths.size();
+        header.block_size = archive_block_size;
+        std::vector<ArchiveEntry> entries(paths.size());
+        std::vector<std::uint32_t> blocks;
+        std::vector<std::vector<std::uint8_t>> payloads(paths.size());
+        std::string strings;
+        std::vector<std::uint8_t> compressed(lz4_bound(archive_block_size));
+        for (std::size_t i = 0; i < paths.size(); ++i) {
+            const auto& content = contents[i];
+            auto& entry = entries[i];
+            auto& payload = payloads[i];
+            entry.size = content.size();
+            entry.first_block = blocks.size();
+            entry.block_count = std::max<std::size_t>(1, (content.size() + archive_block_size - 1) / archive_block_size);
+            entry.path_offset = strings.size();
+            entry.path_size = paths[i].size();
+            strings += paths[i];
+            for (std::uint32_t block = 0; block < entry.block_count; ++block) {
+                const auto begin = content.data() + (std::size_t)block * archive_block_size;
+                const auto size = std::min<std::size_t>(archive_block_size, content.size() - (std::size_t)block * archive_block_size);
+                const auto packed = lz4_compress(begin, size, compressed.data(), compressed.size());
+                crd_likely_if(packed != 0 && packed < size) {
+                    blocks.push_back(packed);
+                    payload.insert(payload.end(), compressed.begin(), compressed.begin() + packed);
+                } else {
+                    blocks.push_back(size | archive_block_stored);
+                    payload.insert(payload.end(), begin, begin + size);
+                }
+            }
+        }
+        header.blocks = blocks.size();
+        header.strings_size = strings.size();
+        auto offset = align(sizeof(header) + entries.size() * sizeof(ArchiveEntry) + blocks.size() * sizeof(std::uint32_t) + strings.size());
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            entries[i].offset = offset;
+            offset = align(offset + payloads[i].size());
+        }
+        std::vector<std::uint8_t> result(offset);
+        auto dest = result.data();
+        std::memcpy(dest, &header, sizeof(header));
+        dest += sizeof(header);
+        std::memcpy(dest, entries.data(), entries.size() * sizeof(ArchiveEntry));
+        dest += entries.size() * sizeof(ArchiveEntry);
+        std::memcpy(dest, blocks.data(), blocks.size() * sizeof(std::uint32_t));
+        dest += blocks.size() * sizeof(std::uint32_t);
+        std::memcpy(dest, strings.data(), strings.size());
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            std::memcpy(result.data() + entries[i].offset, payloads[i].data(), payloads[i].size());
+        }
+        return result;
+    }
+
+    void mount_archive(Archive* archive) noexcept {
+        crd_profile_scoped();
+        mounted.store(archive, std::memory_order_release);
+    }
+
+    crd_nodiscard Archive* mounted_archive() noexcept {
+        return mounted.load(std::memory_order_acquire);
+    }
+} // namespace crd::dtl
@@ -1,48 +1,86 @@
-#include <corundum/detail/file_view.hpp>
-
-#if defined(crd_enable_profiling)
-    #include <Tracy.hpp>
-#endif
-
-#if defined(_WIN32)
-    #include <Windows.h>
-#else
-    #include <sys/mman.h>
-    #include <sys/stat.h>
-    #include <unistd.h>
-    #include <fcntl.h>
-#endif
-
-namespace crd::dtl {
-    crd_nodiscard FileView make_file_view(const char* path) noexcept {
-        crd_profile_scoped();
-        FileView file;
-#if defined(_WIN32)
-        file.handle = CreateFile(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
-        file.mapping = CreateFileMapping(file.handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
-        file.size = GetFileSize(file.handle, nullptr);
-        file.data = MapViewOfFile(file.mapping, FILE_MAP_READ, 0, 0, file.size);
-#else
-        file.handle = open(path, O_RDONLY);
-        struct stat file_info;
-        crd_assert(fstat(file.handle, &file_info) != -1, "failed to get file info");
-        file.data = mmap(nullptr, file_info.st_size, PROT_READ, MAP_PRIVATE, file.handle, 0);
-        file.size = file_info.st_size;
-#endif
-        crd_assert(file.data, "file not found");
-        return file;
-    }
-
-    void destroy_file_view(FileView& file) noexcept {
-        crd_profile_scoped();
-#if defined(_WIN32)
-        UnmapViewOfFile(file.data);
-        CloseHandle(file.handle);
-        CloseHandle(file.mapping);
-#else
-        munmap(const_cast<void*>(file.data), file.size);
-        close(file.handle);
-#endif
-        file = {};
-    }
-} // namespace crd::dtl
+#include <corundum/detail/file_view.hpp>
+#include <corundum/detail/archive.hpp>
+
+#if defined(crd_enable_profiling)
+    #include <Tracy.hpp>
+#endif
+
+#include <spdlog/spdlog.h>
+
+#if defined(_WIN32)
+    #include <Windows.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #include <fcntl.h>
+#endif
+
+#include <filesystem>
+
+namespace crd::dtl {
+    crd_nodiscard FileView make_file_view(const char* path) noexcept {
+        crd_profile_scoped();
+        FileView file = {};
+        const auto archive = mounted_archive();
+        const auto entry = archive ? find_entry(*archive, path) : nullptr;
+        crd_likely_if(entry) {
+            file.archived = true;
+            file.size = entry->size;
+            file.data = stored_entry(*archive, *entry);
+            crd_unlikely_if(!file.data) {
+                file.owned = new std::uint8_t[entry->size];
+                file.data = file.owned;
+                crd_unlikely_if(!extract_entry(*archive, *entry, file.owned)) {
+                    spdlog::error("archive entry \"{}\" is corrupted, falling back to the loose file", path);
+                    destroy_file_view(file);
+                }
+            }
+            crd_likely_if(file.data) {
+                return file;
+            }
+        }
+#if defined(_WIN32)
+        file.handle = CreateFile(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        file.mapping = CreateFileMapping(file.handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        file.size = GetFileSize(file.handle, nullptr);
+        file.data = MapViewOfFile(file.mapping, FILE_MAP_READ, 0, 0, file.size);
+#else
+        file.handle = open(path, O_RDONLY);
+        struct stat file_info;
+        crd_assert(fstat(file.handle, &file_info) != -1, "failed to get file info");
+        file.data = mmap(nullptr, file_info.st_size, PROT_READ, MAP_PRIVATE, file.handle, 0);
+        file.size = file_info.st_size;
+#endif
+        crd_assert(file.data, "file not found");
+        return file;
+    }
+
+    void destroy_file_view(FileView& file) noexcept {
+        crd_profile_scoped();
+        crd_unlikely_if(file.archived) {
+            delete[] file.owned;
+            file = {};
+            return;
+        }
+#if defined(_WIN32)
+        UnmapViewOfFile(file.data);
+        CloseHandle(file.handle);
+        CloseHandle(file.mapping);
+#else
+        munmap(const_cast<void*>(file.data), file.size);
+        close(file.handle);
+#endif
+        file = {};
+    }
+
+    crd_nodiscard bool file_exists(const char* path) noexcept {
+        crd_profile_scoped();
+        const auto archive = mounted_archive();
+        crd_likely_if(archive && find_entry(*archive, path)) {
+            return true;
+        }
+        std::error_code error;
+        return std::filesystem::exists(path, error);
+    }
+} // namespace crd::dtl
@@ -0,0 +1,97 @@
+#include <corundum/detail/interleave.hpp>
+
+#if defined(crd_enable_profiling)
+    #include <Tracy.hpp>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define crd_interleave_sse
+#endif
+
+#include <utility>
+#include <cstring>
+#include <array>
+
+namespace crd::dtl {
+    using InterleaveKernel = void(*)(const VertexStreams&, std::size_t, std::size_t, float*) noexcept;
+
+    static inline void copy_attribute(const float* source, std::size_t index, std::size_t components, float* dest) noexcept {
+        crd_likely_if(source) {
+            std::memcpy(dest, source + index * 3, components * sizeof(float));
+        } else {
+            std::memset(dest, 0, components * sizeof(float));
+        }
+    }
+
+    static inline void interleave_scalar(const VertexStreams& streams, std::size_t first, std::size_t last, float* dest) noexcept {
+        for (auto i = first; i < last; ++i, dest += 14) {
+            copy_attribute(streams.positions, i, 3, dest + 0);
+            copy_attribute(streams.normals, i, 3, dest + 3);
+            copy_attribute(streams.uvs, i, 2, dest + 6);
+            copy_attribute(streams.tangents, i, 3, dest + 8);
+            copy_attribute(streams.bitangents, i, 3, dest + 11);
+        }
+    }
+
+#if defined(crd_interleave_sse)
+    // Every float3 is moved with one unaligned 4-wide load and store. Stores go in ascending order so the
+    // fourth lane is overwritten by the next attribute, the caller keeps the last vertex off this path since
+    // both its loads and its bitangent store would run one float past the end.
+    template <bool normals, bool uvs, bool tangents, bool bitangents>
+    static void interleave_sse(const VertexStreams& streams, std::size_t first, std::size_t last, float* dest) noexcept {
+        crd_profile_scoped();
+        const auto zero = _mm_setzero_ps();
+        for (auto i = first; i < last; ++i, dest += 14) {
+            _mm_storeu_ps(dest + 0, _mm_loadu_ps(streams.positions + i * 3));
+            if constexpr (normals) {
+                _mm_storeu_ps(dest + 3, _mm_loadu_ps(streams.normals + i * 3));
+            } else {
+                _mm_storeu_ps(dest + 3, zero);
+            }
+            if constexpr (uvs) {
+                _mm_store_sd(reinterpret_cast<double*>(dest + 6), _mm_load_sd(reinterpret_cast<const double*>(streams.uvs + i * 3)));
+            } else {
+                _mm_store_sd(reinterpret_cast<double*>(dest + 6), _mm_castps_pd(zero));
+            }
+            if constexpr (tangents) {
+                _mm_storeu_ps(dest + 8, _mm_loadu_ps(streams.tangents + i * 3));
+            } else {
+                _mm_storeu_ps(dest + 8, zero);
+            }
+            if constexpr (bitangents) {
+                _mm_storeu_ps(dest + 11, _mm_loadu_ps(streams.bitangents + i * 3));
+            } else {
+                _mm_storeu_ps(dest + 11, zero);
+            }
+        }
+    }
+
+    template <std::size_t... mask>
+    crd_nodiscard static constexpr auto make_interleave_kernels(std::index_sequence<mask...>) noexcept {
+        return std::array<InterleaveKernel, sizeof...(mask)>{
+            &interleave_sse<(mask & 1) != 0, (mask & 2) != 0, (mask & 4) != 0, (mask & 8) != 0>...
+        };
+    }
+
+    constexpr auto interleave_kernels = make_interleave_kernels(std::make_index_sequence<16>());
+#endif
+
+    void interleave_vertices(const VertexStreams& streams, std::size_t count, float* dest) noexcept {
+        crd_profile_scoped();
+        crd_unlikely_if(count == 0) {
+            return;
+        }
+#if defined(crd_interleave_sse)
+        const auto mask =
+            (streams.normals    ? 1 : 0) |
+            (streams.uvs        ? 2 : 0) |
+            (streams.tangents   ? 4 : 0) |
+            (streams.bitangents ? 8 : 0);
+        interleave_kernels[mask](streams, 0, count - 1, dest);
+        interleave_scalar(streams, count - 1, count, dest + (count - 1) * 14);
+#else
+        interleave_scalar(streams, 0, count, dest);
+#endif
+    }
+} // namespace crd::dtl
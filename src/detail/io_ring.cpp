@@ -0,0 +1,194 @@
+#include <corundum/detail/io_ring.hpp>
+
+#if defined(crd_enable_profiling)
+    #include <Tracy.hpp>
+#endif
+
+#if defined(__linux__)
+    #include <linux/io_uring.h>
+    #include <sys/syscall.h>
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+
+namespace crd::dtl {
+#if defined(__linux__)
+    crd_nodiscard static inline std::uint32_t load_acquire(std::uint32_t* value) noexcept {
+        return std::atomic_ref<std::uint32_t>(*value).load(std::memory_order_acquire);
+    }
+
+    static inline void store_release(std::uint32_t* value, std::uint32_t desired) noexcept {
+        std::atomic_ref<std::uint32_t>(*value).store(desired, std::memory_order_release);
+    }
+
+    crd_nodiscard static inline void* offset_of(void* ring, std::uint32_t offset) noexcept {
+        return static_cast<std::uint8_t*>(ring) + offset;
+    }
+
+    crd_nodiscard static inline io_uring_sqe* next_sqe(IoRing& ring) noexcept {
+        const auto head = load_acquire(ring.sq_head);
+        const auto tail = *ring.sq_tail + ring.queued;
+        crd_unlikely_if(tail - head >= ring.depth) {
+            return nullptr;
+        }
+        const auto index = tail & *ring.sq_mask;
+        auto sqe = static_cast<io_uring_sqe*>(ring.sqes) + index;
+        *sqe = {};
+        ring.sq_array[index] = index;
+        ++ring.queued;
+        return sqe;
+    }
+#endif
+
+    crd_nodiscard bool make_io_ring(IoRing& ring, std::uint32_t depth) noexcept {
+        crd_profile_scoped();
+        ring = {};
+        ring.handle = -1;
+#if defined(__linux__)
+        io_uring_params params = {};
+        const auto handle = (int)syscall(__NR_io_uring_setup, depth, &params);
+        crd_unlikely_if(handle < 0) {
+            return false;
+        }
+        ring.handle = handle;
+        ring.depth = params.sq_entries;
+        ring.sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(std::uint32_t);
+        ring.cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        // Older kernels map the two rings separately.
+        const auto single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        crd_likely_if(single_mmap) {
+            ring.sq_ring_size = ring.cq_ring_size = std::max(ring.sq_ring_size, ring.cq_ring_size);
+        }
+        ring.sq_ring = mmap(nullptr, ring.sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, handle, IORING_OFF_SQ_RING);
+        ring.cq_ring = single_mmap ?
+            ring.sq_ring :
+            mmap(nullptr, ring.cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, handle, IORING_OFF_CQ_RING);
+        ring.sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+        ring.sqes = mmap(nullptr, ring.sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, handle, IORING_OFF_SQES);
+        crd_unlikely_if(ring.sq_ring == MAP_FAILED || ring.cq_ring == MAP_FAILED || ring.sqes == MAP_FAILED) {
+            destroy_io_ring(ring);
+            return false;
+        }
+        ring.sq_head = static_cast<std::uint32_t*>(offset_of(ring.sq_ring, params.sq_off.head));
+        ring.sq_tail = static_cast<std::uint32_t*>(offset_of(ring.sq_ring, params.sq_off.tail));
+        ring.sq_mask = static_cast<std::uint32_t*>(offset_of(ring.sq_ring, params.sq_off.ring_mask));
+        ring.sq_array = static_cast<std::uint32_t*>(offset_of(ring.sq_ring, params.sq_off.array));
+        ring.cq_head = static_cast<std::uint32_t*>(offset_of(ring.cq_ring, params.cq_off.head));
+        ring.cq_tail = static_cast<std::uint32_t*>(offset_of(ring.cq_ring, params.cq_off.tail));
+        ring.cq_mask = static_cast<std::uint32_t*>(offset_of(ring.cq_ring, params.cq_off.ring_mask));
+        ring.cqes = offset_of(ring.cq_ring, params.cq_off.cqes);
+        return true;
+#else
+        (void)depth;
+        return false;
+#endif
+    }
+
+    void destroy_io_ring(IoRing& ring) noexcept {
+        crd_profile_scoped();
+#if defined(__linux__)
+        crd_likely_if(ring.sqes && ring.sqes != MAP_FAILED) {
+            munmap(ring.sqes, ring.sqes_size);
+        }
+        crd_likely_if(ring.cq_ring && ring.cq_ring != MAP_FAILED && ring.cq_ring != ring.sq_ring) {
+            munmap(ring.cq_ring, ring.cq_ring_size);
+        }
+        crd_likely_if(ring.sq_ring && ring.sq_ring != MAP_FAILED) {
+            munmap(ring.sq_ring, ring.sq_ring_size);
+        }
+        crd_likely_if(ring.handle >= 0) {
+            close(ring.handle);
+        }
+#endif
+        ring = {};
+        ring.handle = -1;
+    }
+
+    crd_nodiscard bool queue_read(IoRing& ring, int file, void* dest, std::uint32_t size, std::uint64_t offset, std::uint64_t user) noexcept {
+        crd_profile_scoped();
+#if defined(__linux__)
+        auto sqe = next_sqe(ring);
+        crd_unlikely_if(!sqe) {
+            return false;
+        }
+        sqe->opcode = IORING_OP_READ;
+        sqe->fd = file;
+        sqe->addr = reinterpret_cast<std::uint64_t>(dest);
+        sqe->len = size;
+        sqe->off = offset;
+        sqe->user_data = user;
+        return true;
+#else
+        (void)ring, (void)file, (void)dest, (void)size, (void)offset, (void)user;
+        return false;
+#endif
+    }
+
+    crd_nodiscard bool queue_nop(IoRing& ring, std::uint64_t user) noexcept {
+        crd_profile_scoped();
+#if defined(__linux__)
+        auto sqe = next_sqe(ring);
+        crd_unlikely_if(!sqe) {
+            return false;
+        }
+        sqe->opcode = IORING_OP_NOP;
+        sqe->user_data = user;
+        return true;
+#else
+        (void)ring, (void)user;
+        return false;
+#endif
+    }
+
+    void submit_io_ring(IoRing& ring) noexcept {
+        crd_profile_scoped();
+#if defined(__linux__)
+        crd_unlikely_if(ring.queued == 0) {
+            return;
+        }
+        const auto count = ring.queued;
+        store_release(ring.sq_tail, *ring.sq_tail + count);
+        ring.queued = 0;
+        // Buffered reads of cached pages complete right here, the rest is punted to the kernel's workers.
+        auto submitted = 0;
+        while (submitted < (int)count) {
+            const auto result = (int)syscall(__NR_io_uring_enter, ring.handle, count - submitted, 0, 0, nullptr, 0);
+            crd_unlikely_if(result < 0) {
+                crd_assert(errno == EINTR || errno == EAGAIN || errno == EBUSY, "io_uring_enter failed");
+                continue;
+            }
+            submitted += result;
+        }
+#else
+        (void)ring;
+#endif
+    }
+
+    crd_nodiscard std::uint32_t wait_io_ring(IoRing& ring, IoCompletion* completions, std::uint32_t count) noexcept {
+        crd_profile_scoped();
+#if defined(__linux__)
+        auto head = *ring.cq_head;
+        while (head == load_acquire(ring.cq_tail)) {
+            const auto result = (int)syscall(__NR_io_uring_enter, ring.handle, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+            crd_unlikely_if(result < 0) {
+                crd_assert(errno == EINTR || errno == EAGAIN || errno == EBUSY, "io_uring_enter failed");
+            }
+        }
+        const auto tail = load_acquire(ring.cq_tail);
+        std::uint32_t reaped = 0;
+        for (; head != tail && reaped < count; ++head, ++reaped) {
+            const auto& cqe = static_cast<const io_uring_cqe*>(ring.cqes)[head & *ring.cq_mask];
+            completions[reaped] = { cqe.user_data, cqe.res };
+        }
+        store_release(ring.cq_head, head);
+        return reaped;
+#else
+        (void)ring, (void)completions, (void)count;
+        return 0;
+#endif
+    }
+} // namespace crd::dtl
@@ -0,0 +1,179 @@
+#include <corundum/detail/lz4.hpp>
+
+#if defined(crd_enable_profiling)
+    #include <Tracy.hpp>
+#endif
+
+#include <cstring>
+#include <vector>
+
+namespace crd::dtl {
+    constexpr auto lz4_min_match = 4u;
+    // The last match must start at least this many bytes before the end of the block.
+    constexpr auto lz4_match_limit = 12u;
+    // The last bytes of a block are always literals.
+    constexpr auto lz4_last_literals = 5u;
+    constexpr auto lz4_max_distance = 65535u;
+    constexpr auto lz4_hash_bits = 16u;
+
+    crd_nodiscard static inline std::uint32_t read32(const std::uint8_t* source) noexcept {
+        std::uint32_t value;
+        std::memcpy(&value, source, sizeof(value));
+        return value;
+    }
+
+    crd_nodiscard static inline std::uint32_t hash_sequence(std::uint32_t sequence) noexcept {
+        return (sequence * 2654435761u) >> (32 - lz4_hash_bits);
+    }
+
+    // Writes the 255-continued remainder of a length which overflowed its token nibble.
+    crd_nodiscard static inline bool write_length(std::uint8_t*& dest, const std::uint8_t* end, std::size_t length) noexcept {
+        for (; length >= 255; length -= 255) {
+            crd_unlikely_if(dest == end) {
+                return false;
+            }
+            *dest++ = 255;
+        }
+        crd_unlikely_if(dest == end) {
+            return false;
+        }
+        *dest++ = length;
+        return true;
+    }
+
+    crd_nodiscard static inline bool write_sequence(std::uint8_t*& dest, const std::uint8_t* end, const std::uint8_t* literals, std::size_t literal_count, std::size_t offset, std::size_t match) noexcept {
+        crd_unlikely_if(dest == end) {
+            return false;
+        }
+        auto token = dest++;
+        *token = (literal_count >= 15 ? 15 : literal_count) << 4;
+        crd_unlikely_if(literal_count >= 15 && !write_length(dest, end, literal_count - 15)) {
+            return false;
+        }
+        crd_unlikely_if((std::size_t)(end - dest) < literal_count) {
+            return false;
+        }
+        std::memcpy(dest, literals, literal_count);
+        dest += literal_count;
+        // The final sequence carries literals only.
+        crd_unlikely_if(match == 0) {
+            return true;
+        }
+        crd_unlikely_if(end - dest < 2) {
+            return false;
+        }
+        *dest++ = offset & 0xff;
+        *dest++ = offset >> 8;
+        const auto length = match - lz4_min_match;
+        *token |= length >= 15 ? 15 : length;
+        return length < 15 || write_length(dest, end, length - 15);
+    }
+
+    crd_nodiscard std::size_t lz4_bound(std::size_t size) noexcept {
+        return size + size / 255 + 16;
+    }
+
+    crd_nodiscard std::size_t lz4_compress(const std::uint8_t* source, std::size_t size, std::uint8_t* dest, std::size_t capacity) noexcept {
+        crd_profile_scoped();
+        const auto dest_begin = dest;
+        const auto dest_end = dest + capacity;
+        const auto end = source + size;
+        auto anchor = source;
+        crd_likely_if(size > lz4_match_limit) {
+            // Last position a match may start at, and the last byte it may cover.
+            const auto match_limit = end - lz4_match_limit;
+            const auto match_end = end - lz4_last_literals;
+            std::vector<std::uint32_t> table(1u << lz4_hash_bits, ~0u);
+            auto current = source;
+            while (current < match_limit) {
+                const auto sequence = read32(current);
+                auto& slot = table[hash_sequence(sequence)];
+                const auto candidate = slot;
+                slot = current - source;
+                crd_likely_if(candidate == ~0u ||
+                              (std::size_t)(current - source) - candidate > lz4_max_distance ||
+                              read32(source + candidate) != sequence) {
+                    ++current;
+                    continue;
+                }
+                auto reference = source + candidate;
+                // Extend backwards over literals which also match.
+                while (current > anchor && reference > source && current[-1] == reference[-1]) {
+                    --current;
+                    --reference;
+                }
+                auto length = lz4_min_match;
+                while (current + length < match_end && current[length] == reference[length]) {
+                    ++length;
+                }
+                crd_unlikely_if(!write_sequence(dest, dest_end, anchor, current - anchor, current - reference, length)) {
+                    return 0;
+                }
+                current += length;
+                anchor = current;
+            }
+        }
+        crd_unlikely_if(!write_sequence(dest, dest_end, anchor, end - anchor, 0, 0)) {
+            return 0;
+        }
+        return dest - dest_begin;
+    }
+
+    crd_nodiscard bool lz4_decompress(const std::uint8_t* source, std::size_t size, std::uint8_t* dest, std::size_t dest_size) noexcept {
+        crd_profile_scoped();
+        const auto end = source + size;
+        const auto dest_begin = dest;
+        const auto dest_end = dest + dest_size;
+        const auto read_length = [&](std::size_t& length) noexcept {
+            std::uint8_t byte;
+            do {
+                crd_unlikely_if(source == end) {
+                    return false;
+                }
+                byte = *source++;
+                length += byte;
+            } while (byte == 255);
+            return true;
+        };
+        while (source < end) {
+            const auto token = *source++;
+            std::size_t literals = token >> 4;
+            crd_unlikely_if(literals == 15 && !read_length(literals)) {
+                return false;
+            }
+            crd_unlikely_if((std::size_t)(end - source) < literals || (std::size_t)(dest_end - dest) < literals) {
+                return false;
+            }
+            std::memcpy(dest, source, literals);
+            source += literals;
+            dest += literals;
+            crd_unlikely_if(source == end) {
+                break;
+            }
+            crd_unlikely_if(end - source < 2) {
+                return false;
+            }
+            const std::size_t offset = source[0] | (source[1] << 8);
+            source += 2;
+            std::size_t length = token & 15;
+            crd_unlikely_if(length == 15 && !read_length(length)) {
+                return false;
+            }
+            length += lz4_min_match;
+            crd_unlikely_if(offset == 0 || offset > (std::size_t)(dest - dest_begin) || (std::size_t)(dest_end - dest) < length) {
+                return false;
+            }
+            // Matches may overlap their own output, copied byte by byte in that case.
+            const auto reference = dest - offset;
+            crd_likely_if(offset >= length) {
+                std::memcpy(dest, reference, length);
+            } else {
+                for (std::size_t i = 0; i < length; ++i) {
+                    dest[i] = reference[i];
+                }
+            }
+            dest += length;
+        }
+        return dest == dest_end;
+    }
+} // namespace crd::dtl
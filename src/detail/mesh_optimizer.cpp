@@ -0,0 +1,197 @@
+#include <corundum/detail/mesh_optimizer.hpp>
+
+#if defined(crd_enable_profiling)
+    #include <Tracy.hpp>
+#endif
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <deque>
+
+namespace crd::dtl {
+    constexpr auto invalid_vertex = std::numeric_limits<std::uint32_t>::max();
+
+    crd_nodiscard static inline std::uint64_t hash_vertex(const std::uint8_t* vertex, std::size_t stride) noexcept {
+        // FNV-1a
+        std::uint64_t hash = 14695981039346656037ull;
+        for (std::size_t i = 0; i < stride; ++i) {
+            hash ^= vertex[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    void weld_vertices(std::vector<std::uint8_t>& geometry, std::vector<std::uint32_t>& indices, std::size_t stride) noexcept {
+        crd_profile_scoped();
+        const auto vertex_count = geometry.size() / stride;
+        std::size_t buckets = 1;
+        while (buckets < vertex_count * 2) {
+            buckets <<= 1;
+        }
+        // Open addressing with linear probing, slots hold indices of already welded vertices.
+        std::vector<std::uint32_t> table(buckets, invalid_vertex);
+        std::vector<std::uint32_t> remap(vertex_count);
+        std::uint32_t welded = 0;
+        for (std::size_t i = 0; i < vertex_count; ++i) {
+            const auto vertex = geometry.data() + i * stride;
+            auto slot = hash_vertex(vertex, stride) & (buckets - 1);
+            while (table[slot] != invalid_vertex &&
+                   std::memcmp(geometry.data() + table[slot] * stride, vertex, stride) != 0) {
+                slot = (slot + 1) & (buckets - 1);
+            }
+            crd_likely_if(table[slot] == invalid_vertex) {
+                crd_likely_if(welded != i) {
+                    std::memcpy(geometry.data() + welded * stride, vertex, stride);
+                }
+                table[slot] = welded++;
+            }
+            remap[i] = table[slot];
+        }
+        for (auto& index : indices) {
+            index = remap[index];
+        }
+        geometry.resize(welded * stride);
+    }
+
+    void optimize_vertex_cache(std::vector<std::uint32_t>& indices, std::size_t vertex_count) noexcept {
+        crd_profile_scoped();
+        const auto triangle_count = indices.size() / 3;
+        // Vertex -> triangle adjacency, stored as offsets into one flat list.
+        std::vector<std::uint32_t> live(vertex_count, 0);
+        for (const auto index : indices) {
+            ++live[index];
+        }
+        std::vector<std::uint32_t> offsets(vertex_count + 1, 0);
+        for (std::size_t i = 0; i < vertex_count; ++i) {
+            offsets[i + 1] = offsets[i] + live[i];
+        }
+        std::vector<std::uint32_t> adjacency(indices.size());
+        {
+            auto cursor = offsets;
+            for (std::size_t i = 0; i < indices.size(); ++i) {
+                adjacency[cursor[indices[i]]++] = i / 3;
+            }
+        }
+        std::vector<std::uint32_t> cache_time(vertex_count, 0);
+        std::vector<std::uint32_t> dead_end;
+        std::vector<std::uint32_t> candidates;
+        std::vector<std::uint8_t> emitted(triangle_count, false);
+        std::vector<std::uint32_t> result;
+        result.reserve(indices.size());
+        std::uint32_t time = vertex_cache_size + 1;
+        std::size_t cursor = 0;
+        auto fanning = vertex_count > 0 ? 0 : invalid_vertex;
+        while (fanning != invalid_vertex) {
+            candidates.clear();
+            for (auto i = offsets[fanning]; i < offsets[fanning + 1]; ++i) {
+                const auto triangle = adjacency[i];
+                crd_unlikely_if(emitted[triangle]) {
+                    continue;
+                }
+                for (std::size_t j = 0; j < 3; ++j) {
+                    const auto vertex = indices[triangle * 3 + j];
+                    result.emplace_back(vertex);
+                    dead_end.emplace_back(vertex);
+                    candidates.emplace_back(vertex);
+                    --live[vertex];
+                    crd_likely_if(time - cache_time[vertex] > vertex_cache_size) {
+                        cache_time[vertex] = time++;
+                    }
+                }
+                emitted[triangle] = true;
+            }
+            // Prefer the candidate that stays in the cache for its remaining triangles and entered it earliest.
+            auto best = invalid_vertex;
+            auto priority = -1;
+            for (const auto vertex : candidates) {
+                crd_unlikely_if(live[vertex] == 0) {
+                    continue;
+                }
+                auto current = 0;
+                crd_likely_if(time - cache_time[vertex] + 2 * live[vertex] <= vertex_cache_size) {
+                    current = time - cache_time[vertex];
+                }
+                crd_unlikely_if(current > priority) {
+                    priority = current;
+                    best = vertex;
+                }
+            }
+            crd_unlikely_if(best == invalid_vertex) {
+                while (!dead_end.empty()) {
+                    const auto vertex = dead_end.back();
+                    dead_end.pop_back();
+                    crd_likely_if(live[vertex] > 0) {
+                        best = vertex;
+                        break;
+                    }
+                }
+            }
+            crd_unlikely_if(best == invalid_vertex) {
+                while (cursor < vertex_count) {
+                    crd_unlikely_if(live[cursor] > 0) {
+                        best = static_cast<std::uint32_t>(cursor);
+                        break;
+                    }
+                    ++cursor;
+                }
+            }
+            fanning = best;
+        }
+        indices = std::move(result);
+    }
+
+    void optimize_vertex_fetch(std::vector<std::uint8_t>& geometry, std::vector<std::uint32_t>& indices, std::size_t stride) noexcept {
+        crd_profile_scoped();
+        const auto vertex_count = geometry.size() / stride;
+        std::vector<std::uint32_t> remap(vertex_count, invalid_vertex);
+        std::vector<std::uint8_t> result(geometry.size());
+        std::uint32_t next = 0;
+        for (auto& index : indices) {
+            crd_unlikely_if(remap[index] == invalid_vertex) {
+                std::memcpy(result.data() + next * stride, geometry.data() + index * stride, stride);
+                remap[index] = next++;
+            }
+            index = remap[index];
+        }
+        result.resize(next * stride);
+        geometry = std::move(result);
+    }
+
+    crd_nodiscard float compute_acmr(const std::vector<std::uint32_t>& indices, std::size_t vertex_count) noexcept {
+        crd_profile_scoped();
+        crd_unlikely_if(indices.empty()) {
+            return 0;
+        }
+        std::vector<std::uint8_t> cached(vertex_count, false);
+        std::deque<std::uint32_t> fifo;
+        std::size_t misses = 0;
+        for (const auto index : indices) {
+            crd_likely_if(cached[index]) {
+                continue;
+            }
+            ++misses;
+            cached[index] = true;
+            fifo.emplace_back(index);
+            crd_likely_if(fifo.size() > vertex_cache_size) {
+                cached[fifo.front()] = false;
+                fifo.pop_front();
+            }
+        }
+        return (float)misses / (indices.size() / 3);
+    }
+
+    void optimize_mesh(std::vector<std::uint8_t>& geometry, std::vector<std::uint32_t>& indices, std::size_t stride) noexcept {
+        crd_profile_scoped();
+        const auto vertices_before = geometry.size() / stride;
+        const auto acmr_before = compute_acmr(indices, vertices_before);
+        weld_vertices(geometry, indices, stride);
+        optimize_vertex_cache(indices, geometry.size() / stride);
+        optimize_vertex_fetch(geometry, indices, stride);
+        const auto vertices_after = geometry.size() / stride;
+        spdlog::info("mesh optimized, vertices: {} -> {}, ACMR: {:.3f} -> {:.3f}",
+                     vertices_before, vertices_after, acmr_before, compute_acmr(indices, vertices_after));
+    }
+} // namespace crd::dtl
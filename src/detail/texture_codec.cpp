@@ -0,0 +1,485 @@
+#include <corundum/detail/texture_codec.hpp>
+
+#if defined(crd_enable_profiling)
+    #include <Tracy.hpp>
+#endif
+
+#include <ftl/task_scheduler.h>
+#include <ftl/wait_group.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define crd_mips_sse
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <vector>
+#include <array>
+#include <cmath>
+
+namespace crd::dtl {
+    // A 4x4 block of RGBA8 texels in row-major order.
+    using TexelBlock = std::array<std::uint8_t, 64>;
+
+    crd_nodiscard static inline float srgb_to_linear(std::uint8_t value) noexcept {
+        const auto x = value / 255.0f;
+        return x <= 0.04045f ? x / 12.92f : std::pow((x + 0.055f) / 1.055f, 2.4f);
+    }
+
+    crd_nodiscard static inline std::uint8_t linear_to_srgb(float value) noexcept {
+        const auto x = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1 / 2.4f) - 0.055f;
+        return (std::uint8_t)std::clamp(x * 255.0f + 0.5f, 0.0f, 255.0f);
+    }
+
+    crd_nodiscard static inline TexelBlock fetch_block(const std::uint8_t* rgba, std::uint32_t width, std::uint32_t height, std::uint32_t bx, std::uint32_t by) noexcept {
+        TexelBlock block;
+        for (std::uint32_t y = 0; y < 4; ++y) {
+            for (std::uint32_t x = 0; x < 4; ++x) {
+                // Partial blocks on the right and bottom edges replicate the last row and column.
+                const auto sx = std::min(bx * 4 + x, width - 1);
+                const auto sy = std::min(by * 4 + y, height - 1);
+                std::memcpy(&block[(y * 4 + x) * 4], rgba + ((std::size_t)sy * width + sx) * 4, 4);
+            }
+        }
+        return block;
+    }
+
+    // Writes `count` bits of `value` at bit `offset` of a little-endian block.
+    static inline void write_bits(std::uint8_t* block, std::uint32_t& offset, std::uint32_t count, std::uint32_t value) noexcept {
+        for (std::uint32_t i = 0; i < count; ++i, ++offset) {
+            block[offset / 8] |= ((value >> i) & 1) << (offset % 8);
+        }
+    }
+
+    crd_nodiscard static inline std::uint16_t pack_565(const std::uint8_t* color) noexcept {
+        return ((color[0] >> 3) << 11) | ((color[1] >> 2) << 5) | (color[2] >> 3);
+    }
+
+    static inline void unpack_565(std::uint16_t packed, std::int32_t* color) noexcept {
+        const auto r = (packed >> 11) & 31;
+        const auto g = (packed >> 5) & 63;
+        const auto b = packed & 31;
+        color[0] = (r << 3) | (r >> 2);
+        color[1] = (g << 2) | (g >> 4);
+        color[2] = (b << 3) | (b >> 2);
+    }
+
+    // Endpoints of the block's principal axis (power iteration on the covariance), clamped to the block's extents.
+    static inline void fit_endpoints(const TexelBlock& texels, std::size_t channels, float* low, float* high) noexcept {
+        float mean[4] = {};
+        for (std::size_t i = 0; i < 16; ++i) {
+            for (std::size_t c = 0; c < channels; ++c) {
+                mean[c] += texels[i * 4 + c] / 16.0f;
+            }
+        }
+        float covariance[4][4] = {};
+        for (std::size_t i = 0; i < 16; ++i) {
+            for (std::size_t a = 0; a < channels; ++a) {
+                for (std::size_t b = 0; b < channels; ++b) {
+                    covariance[a][b] += (texels[i * 4 + a] - mean[a]) * (texels[i * 4 + b] - mean[b]);
+                }
+            }
+        }
+        float axis[4] = { 1, 1, 1, 1 };
+        for (std::size_t iteration = 0; iteration < 8; ++iteration) {
+            float next[4] = {};
+            auto length = 0.0f;
+            for (std::size_t a = 0; a < channels; ++a) {
+                for (std::size_t b = 0; b < channels; ++b) {
+                    next[a] += covariance[a][b] * axis[b];
+                }
+                length = std::max(length, std::abs(next[a]));
+            }
+            crd_unlikely_if(length == 0) {
+                break;
+            }
+            for (std::size_t c = 0; c < channels; ++c) {
+                axis[c] = next[c] / length;
+            }
+        }
+        auto min = std::numeric_limits<float>::max();
+        auto max = std::numeric_limits<float>::lowest();
+        auto norm = 0.0f;
+        for (std::size_t c = 0; c < channels; ++c) {
+            norm += axis[c] * axis[c];
+        }
+        for (std::size_t i = 0; i < 16; ++i) {
+            auto t = 0.0f;
+            for (std::size_t c = 0; c < channels; ++c) {
+                t += (texels[i * 4 + c] - mean[c]) * axis[c];
+            }
+            min = std::min(min, t / norm);
+            max = std::max(max, t / norm);
+        }
+        for (std::size_t c = 0; c < channels; ++c) {
+            low[c] = std::clamp(mean[c] + min * axis[c], 0.0f, 255.0f);
+            high[c] = std::clamp(mean[c] + max * axis[c], 0.0f, 255.0f);
+        }
+    }
+
+    // Principal axis endpoints inset by 1/16th of the range, see "Real-Time DXT Compression" (van Waveren).
+    static inline void encode_bc1(const TexelBlock& texels, std::uint8_t* output) noexcept {
+        float low[3];
+        float high[3];
+        fit_endpoints(texels, 3, low, high);
+        std::uint8_t min[3];
+        std::uint8_t max[3];
+        for (std::size_t c = 0; c < 3; ++c) {
+            const auto inset = (high[c] - low[c]) / 16;
+            min[c] = (std::uint8_t)std::clamp(low[c] + inset + 0.5f, 0.0f, 255.0f);
+            max[c] = (std::uint8_t)std::clamp(high[c] - inset + 0.5f, 0.0f, 255.0f);
+        }
+        auto color0 = pack_565(max);
+        auto color1 = pack_565(min);
+        std::uint32_t indices = 0;
+        crd_likely_if(color0 != color1) {
+            crd_unlikely_if(color0 < color1) {
+                std::swap(color0, color1);
+            }
+            std::int32_t palette[4][3];
+            unpack_565(color0, palette[0]);
+            unpack_565(color1, palette[1]);
+            for (std::size_t c = 0; c < 3; ++c) {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+            }
+            for (std::size_t i = 0; i < 16; ++i) {
+                auto best = 0u;
+                auto best_error = std::numeric_limits<std::int32_t>::max();
+                for (std::uint32_t p = 0; p < 4; ++p) {
+                    std::int32_t error = 0;
+                    for (std::size_t c = 0; c < 3; ++c) {
+                        const auto delta = texels[i * 4 + c] - palette[p][c];
+                        error += delta * delta;
+                    }
+                    crd_unlikely_if(error < best_error) {
+                        best_error = error;
+                        best = p;
+                    }
+                }
+                indices |= best << (i * 2);
+            }
+        }
+        std::memcpy(output + 0, &color0, 2);
+        std::memcpy(output + 2, &color1, 2);
+        std::memcpy(output + 4, &indices, 4);
+    }
+
+    // Single channel, always in the 8-value mode unless the block is flat.
+    static inline void encode_bc4(const TexelBlock& texels, std::size_t channel, std::uint8_t* output) noexcept {
+        std::uint8_t min = 255;
+        std::uint8_t max = 0;
+        for (std::size_t i = 0; i < 16; ++i) {
+            min = std::min(min, texels[i * 4 + channel]);
+            max = std::max(max, texels[i * 4 + channel]);
+        }
+        std::memset(output, 0, 8);
+        output[0] = max;
+        output[1] = min;
+        crd_unlikely_if(max == min) {
+            return;
+        }
+        std::int32_t palette[8] = { max, min };
+        for (std::int32_t i = 1; i < 7; ++i) {
+            palette[i + 1] = ((7 - i) * max + i * min) / 7;
+        }
+        std::uint32_t offset = 16;
+        for (std::size_t i = 0; i < 16; ++i) {
+            auto best = 0u;
+            auto best_error = std::numeric_limits<std::int32_t>::max();
+            for (std::uint32_t p = 0; p < 8; ++p) {
+                const auto error = std::abs(texels[i * 4 + channel] - palette[p]);
+                crd_unlikely_if(error < best_error) {
+                    best_error = error;
+                    best = p;
+                }
+            }
+            write_bits(output, offset, 3, best);
+        }
+    }
+
+    // Mode 6: one subset, RGBA 7.7.7.7 endpoints with a unique p-bit each, 4-bit indices.
+    static inline void encode_bc7(const TexelBlock& texels, std::uint8_t* output) noexcept {
+        constexpr std::int32_t weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+        float fitted[2][4];
+        fit_endpoints(texels, 4, fitted[0], fitted[1]);
+        std::int32_t low[4];
+        std::int32_t high[4];
+        for (std::size_t c = 0; c < 4; ++c) {
+            low[c] = (std::int32_t)(fitted[0][c] + 0.5f);
+            high[c] = (std::int32_t)(fitted[1][c] + 0.5f);
+        }
+        std::int32_t quantized[2][4];
+        std::int32_t pbits[2];
+        std::int32_t endpoints[2][4];
+        for (std::size_t e = 0; e < 2; ++e) {
+            const auto* source = e == 0 ? low : high;
+            auto best_error = std::numeric_limits<std::int32_t>::max();
+            for (std::int32_t pbit = 0; pbit < 2; ++pbit) {
+                std::int32_t error = 0;
+                std::int32_t candidate[4];
+                for (std::size_t c = 0; c < 4; ++c) {
+                    candidate[c] = std::clamp((source[c] - pbit + 1) >> 1, 0, 127);
+                    const auto delta = source[c] - ((candidate[c] << 1) | pbit);
+                    error += delta * delta;
+                }
+                crd_unlikely_if(error < best_error) {
+                    best_error = error;
+                    pbits[e] = pbit;
+                    std::memcpy(quantized[e], candidate, sizeof(candidate));
+                }
+            }
+            for (std::size_t c = 0; c < 4; ++c) {
+                endpoints[e][c] = (quantized[e][c] << 1) | pbits[e];
+            }
+        }
+        std::int32_t palette[16][4];
+        for (std::size_t w = 0; w < 16; ++w) {
+            for (std::size_t c = 0; c < 4; ++c) {
+                palette[w][c] = ((64 - weights[w]) * endpoints[0][c] + weights[w] * endpoints[1][c] + 32) >> 6;
+            }
+        }
+        std::uint32_t indices[16];
+        for (std::size_t i = 0; i < 16; ++i) {
+            auto best = 0u;
+            auto best_error = std::numeric_limits<std::int32_t>::max();
+            for (std::uint32_t w = 0; w < 16; ++w) {
+                std::int32_t error = 0;
+                for (std::size_t c = 0; c < 4; ++c) {
+                    const auto delta = texels[i * 4 + c] - palette[w][c];
+                    error += delta * delta;
+                }
+                crd_unlikely_if(error < best_error) {
+                    best_error = error;
+                    best = w;
+                }
+            }
+            indices[i] = best;
+        }
+        // The anchor index is stored without its top bit, swap the endpoints to keep it clear.
+        crd_unlikely_if(indices[0] & 8) {
+            std::swap(quantized[0], quantized[1]);
+            std::swap(pbits[0], pbits[1]);
+            for (auto& index : indices) {
+                index = 15 - index;
+            }
+        }
+        std::memset(output, 0, 16);
+        std::uint32_t offset = 0;
+        write_bits(output, offset, 7, 1 << 6);
+        for (std::size_t c = 0; c < 4; ++c) {
+            write_bits(output, offset, 7, quantized[0][c]);
+            write_bits(output, offset, 7, quantized[1][c]);
+        }
+        write_bits(output, offset, 1, pbits[0]);
+        write_bits(output, offset, 1, pbits[1]);
+        write_bits(output, offset, 3, indices[0]);
+        for (std::size_t i = 1; i < 16; ++i) {
+            write_bits(output, offset, 4, indices[i]);
+        }
+    }
+
+    // Entries of the linear -> 8-bit encode table, fine enough to stay under half a step of sRGB near black.
+    constexpr auto mip_encode_size = 8192u;
+    // Rough amount of output texels handed to one fiber.
+    constexpr auto mip_task_texels = 16384u;
+
+    struct MipTables {
+        float linear[4][256];
+        std::uint8_t encode[mip_encode_size];
+    };
+
+    struct MipJob {
+        const MipTables* tables;
+        const std::uint8_t* source;
+        std::uint32_t source_width;
+        std::uint32_t source_height;
+        std::uint8_t* dest;
+        std::uint32_t width;
+        std::uint32_t first_row;
+        std::uint32_t last_row;
+    };
+
+    // 2x2 box filter, the last row and column are clamped for odd sizes. Decoding and encoding go through
+    // lookup tables, the four-texel sum and the scale run four channels wide.
+    static void downsample_rows(const MipJob& job) noexcept {
+        crd_profile_scoped();
+        const auto& linear = job.tables->linear;
+        const auto& encode = job.tables->encode;
+        for (auto y = job.first_row; y < job.last_row; ++y) {
+            const auto top = job.source + (std::size_t)(y * 2) * job.source_width * 4;
+            const auto bottom = job.source + (std::size_t)std::min(y * 2 + 1, job.source_height - 1) * job.source_width * 4;
+            auto dest = job.dest + (std::size_t)y * job.width * 4;
+            for (std::uint32_t x = 0; x < job.width; ++x, dest += 4) {
+                const std::size_t left = x * 2 * 4;
+                const std::size_t right = std::min(x * 2 + 1, job.source_width - 1) * 4;
+                const std::uint8_t* texels[4] = { top + left, top + right, bottom + left, bottom + right };
+#if defined(crd_mips_sse)
+                auto sum = _mm_setzero_ps();
+                for (const auto texel : texels) {
+                    sum = _mm_add_ps(sum, _mm_setr_ps(linear[0][texel[0]], linear[1][texel[1]], linear[2][texel[2]], linear[3][texel[3]]));
+                }
+                const auto scale = _mm_setr_ps(0.25f * (mip_encode_size - 1), 0.25f * (mip_encode_size - 1), 0.25f * (mip_encode_size - 1), 0.25f * 255);
+                alignas(16) std::int32_t indices[4];
+                _mm_store_si128(reinterpret_cast<__m128i*>(indices), _mm_cvtps_epi32(_mm_mul_ps(sum, scale)));
+#else
+                float sum[4] = {};
+                for (const auto texel : texels) {
+                    for (std::size_t c = 0; c < 4; ++c) {
+                        sum[c] += linear[c][texel[c]];
+                    }
+                }
+                const std::int32_t indices[4] = {
+                    (std::int32_t)std::lround(sum[0] * 0.25f * (mip_encode_size - 1)),
+                    (std::int32_t)std::lround(sum[1] * 0.25f * (mip_encode_size - 1)),
+                    (std::int32_t)std::lround(sum[2] * 0.25f * (mip_encode_size - 1)),
+                    (std::int32_t)std::lround(sum[3] * 0.25f * 255)
+                };
+#endif
+                dest[0] = encode[indices[0]];
+                dest[1] = encode[indices[1]];
+                dest[2] = encode[indices[2]];
+                dest[3] = (std::uint8_t)indices[3];
+            }
+        }
+    }
+
+    crd_nodiscard std::size_t block_size(TextureCodec codec) noexcept {
+        return codec == texture_codec_bc1 ? 8 : 16;
+    }
+
+    crd_nodiscard std::uint32_t mip_count(std::uint32_t width, std::uint32_t height) noexcept {
+        return (std::uint32_t)std::floor(std::log2(std::max(width, height))) + 1;
+    }
+
+    crd_nodiscard std::vector<std::size_t> mip_chain_offsets(std::uint32_t width, std::uint32_t height) noexcept {
+        std::vector<std::size_t> offsets = { 0 };
+        const auto mips = mip_count(width, height);
+        for (std::uint32_t mip = 0; mip < mips; ++mip) {
+            offsets.emplace_back(offsets.back() + (std::size_t)std::max(width >> mip, 1u) * std::max(height >> mip, 1u) * 4);
+        }
+        return offsets;
+    }
+
+    void build_mips(const std::uint8_t* rgba, std::uint32_t width, std::uint32_t height, bool srgb, std::uint8_t* dest, ftl::TaskScheduler* scheduler) noexcept {
+        crd_profile_scoped();
+        MipTables tables;
+        for (std::size_t i = 0; i < 256; ++i) {
+            const auto linear = srgb ? srgb_to_linear(i) : i / 255.0f;
+            tables.linear[0][i] = linear;
+            tables.linear[1][i] = linear;
+            tables.linear[2][i] = linear;
+            tables.linear[3][i] = i / 255.0f;
+        }
+        for (std::size_t i = 0; i < mip_encode_size; ++i) {
+            const auto linear = i / (float)(mip_encode_size - 1);
+            tables.encode[i] = srgb ?
+                linear_to_srgb(linear) :
+                (std::uint8_t)(linear * 255.0f + 0.5f);
+        }
+        const auto offsets = mip_chain_offsets(width, height);
+        std::memcpy(dest, rgba, offsets[1]);
+        std::vector<MipJob> jobs;
+        std::vector<ftl::Task> tasks;
+        for (std::size_t mip = 1; mip + 1 < offsets.size(); ++mip) {
+            const auto source_width = std::max(width >> (mip - 1), 1u);
+            const auto source_height = std::max(height >> (mip - 1), 1u);
+            const auto level_width = std::max(width >> mip, 1u);
+            const auto level_height = std::max(height >> mip, 1u);
+            const auto rows = std::max(mip_task_texels / level_width, 1u);
+            jobs.clear();
+            for (std::uint32_t row = 0; row < level_height; row += rows) {
+                jobs.push_back({
+                    &tables,
+                    dest + offsets[mip - 1],
+                    source_width,
+                    source_height,
+                    dest + offsets[mip],
+                    level_width,
+                    row,
+                    std::min(row + rows, level_height)
+                });
+            }
+            // Levels depend on each other, only the rows within one level run concurrently.
+            crd_likely_if(!scheduler || jobs.size() == 1) {
+                for (const auto& job : jobs) {
+                    downsample_rows(job);
+                }
+                continue;
+            }
+            tasks.clear();
+            for (auto& job : jobs) {
+                tasks.push_back({
+                    .Function = +[](ftl::TaskScheduler*, void* data) {
+                        downsample_rows(*static_cast<const MipJob*>(data));
+                    },
+                    .ArgData = &job
+                });
+            }
+            ftl::WaitGroup waiter(scheduler);
+            scheduler->AddTasks(tasks.size(), tasks.data(), ftl::TaskPriority::High, &waiter);
+            waiter.Wait();
+        }
+    }
+
+    crd_nodiscard std::vector<std::uint8_t> compress_blocks(const std::uint8_t* rgba, std::uint32_t width, std::uint32_t height, TextureCodec codec) noexcept {
+        crd_profile_scoped();
+        const auto blocks_x = (width + 3) / 4;
+        const auto blocks_y = (height + 3) / 4;
+        const auto stride = block_size(codec);
+        std::vector<std::uint8_t> result((std::size_t)blocks_x * blocks_y * stride);
+        auto output = result.data();
+        for (std::uint32_t by = 0; by < blocks_y; ++by) {
+            for (std::uint32_t bx = 0; bx < blocks_x; ++bx, output += stride) {
+                const auto texels = fetch_block(rgba, width, height, bx, by);
+                switch (codec) {
+                    case texture_codec_bc1:
+                        encode_bc1(texels, output);
+                        break;
+                    case texture_codec_bc3:
+                        encode_bc4(texels, 3, output);
+                        encode_bc1(texels, output + 8);
+                        break;
+                    case texture_codec_bc5:
+                        encode_bc4(texels, 0, output);
+                        encode_bc4(texels, 1, output + 8);
+                        break;
+                    case texture_codec_bc7:
+                        encode_bc7(texels, output);
+                        break;
+                }
+            }
+        }
+        return result;
+    }
+
+    crd_nodiscard std::vector<std::uint8_t> cook_texture(const std::uint8_t* rgba, std::uint32_t width, std::uint32_t height, bool srgb, TextureCodec codec) noexcept {
+        crd_profile_scoped();
+        const auto offsets = mip_chain_offsets(width, height);
+        std::vector<std::uint8_t> chain(offsets.back());
+        build_mips(rgba, width, height, srgb, chain.data());
+        CookedTextureHeader header;
+        header.magic = cooked_texture_magic;
+        header.version = cooked_texture_version;
+        header.codec = codec;
+        header.srgb = srgb;
+        header.width = width;
+        header.height = height;
+        header.mips = offsets.size() - 1;
+        header.reserved = 0;
+        std::vector<CookedMip> mips(header.mips);
+        std::vector<std::uint8_t> result(sizeof(header) + mips.size() * sizeof(CookedMip));
+        for (std::uint32_t i = 0; i < header.mips; ++i) {
+            const auto blocks = compress_blocks(chain.data() + offsets[i], std::max(width >> i, 1u), std::max(height >> i, 1u), codec);
+            mips[i].offset = (result.size() + 15) & ~15ull;
+            mips[i].size = blocks.size();
+            result.resize(mips[i].offset);
+            result.insert(result.end(), blocks.begin(), blocks.end());
+        }
+        std::memcpy(result.data(), &header, sizeof(header));
+        std::memcpy(result.data() + sizeof(header), mips.data(), mips.size() * sizeof(CookedMip));
+        return result;
+    }
+} // namespace crd::dtl
@@ -0,0 +1,84 @@
+#include <corundum/detail/interleave.hpp>
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cstring>
+#include <chrono>
+#include <random>
+#include <vector>
+
+// Reference: the per-vertex, per-attribute branching loop import_textured_mesh used before the kernels.
+static void interleave_reference(const crd::dtl::VertexStreams& streams, std::size_t count, float* ptr) noexcept {
+    for (std::size_t i = 0; i < count; ++i) {
+        ptr[0] = streams.positions[i * 3 + 0];
+        ptr[1] = streams.positions[i * 3 + 1];
+        ptr[2] = streams.positions[i * 3 + 2];
+        if (streams.normals) {
+            ptr[3] = streams.normals[i * 3 + 0];
+            ptr[4] = streams.normals[i * 3 + 1];
+            ptr[5] = streams.normals[i * 3 + 2];
+        }
+        if (streams.uvs) {
+            ptr[6] = streams.uvs[i * 3 + 0];
+            ptr[7] = streams.uvs[i * 3 + 1];
+        }
+        if (streams.tangents) {
+            ptr[8] = streams.tangents[i * 3 + 0];
+            ptr[9] = streams.tangents[i * 3 + 1];
+            ptr[10] = streams.tangents[i * 3 + 2];
+        }
+        if (streams.bitangents) {
+            ptr[11] = streams.bitangents[i * 3 + 0];
+            ptr[12] = streams.bitangents[i * 3 + 1];
+            ptr[13] = streams.bitangents[i * 3 + 2];
+        }
+        ptr += 14;
+    }
+}
+
+template <typename F>
+static double vertices_per_second(std::size_t count, std::size_t iterations, F&& function) noexcept {
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; ++i) {
+        function();
+    }
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return (double)(count * iterations) / elapsed;
+}
+
+int main() {
+    constexpr auto count = 1u << 20;
+    constexpr auto iterations = 32u;
+    std::mt19937 engine(42);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    std::vector<float> attributes[5];
+    for (auto& each : attributes) {
+        each.resize(count * 3);
+        std::generate(each.begin(), each.end(), [&]() { return distribution(engine); });
+    }
+    const crd::dtl::VertexStreams streams = {
+        .positions = attributes[0].data(),
+        .normals = attributes[1].data(),
+        .uvs = attributes[2].data(),
+        .tangents = attributes[3].data(),
+        .bitangents = attributes[4].data()
+    };
+    std::vector<float> reference(count * 14);
+    std::vector<float> result(count * 14);
+    interleave_reference(streams, count, reference.data());
+    crd::dtl::interleave_vertices(streams, count, result.data());
+    if (std::memcmp(reference.data(), result.data(), reference.size() * sizeof(float)) != 0) {
+        spdlog::critical("interleave kernel output differs from the reference");
+        return 1;
+    }
+    const auto before = vertices_per_second(count, iterations, [&]() {
+        interleave_reference(streams, count, reference.data());
+    });
+    const auto after = vertices_per_second(count, iterations, [&]() {
+        crd::dtl::interleave_vertices(streams, count, result.data());
+    });
+    spdlog::info("reference: {:.1f} Mvertices/s", before / 1e6);
+    spdlog::info("kernel:    {:.1f} Mvertices/s ({:.2f}x)", after / 1e6, after / before);
+    return 0;
+}
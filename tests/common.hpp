@@ -10,6 +10,7 @@
 #if defined(crd_enable_raytracing)
     #include <corundum/core/acceleration_structure.hpp>
 #endif
+#include <corundum/core/geometry_arena.hpp>
 #include <corundum/core/descriptor_set.hpp>
 #include <corundum/core/static_texture.hpp>
 #include <corundum/core/static_model.hpp>
@@ -19,6 +20,7 @@
 #include <corundum/core/swapchain.hpp>
 #include <corundum/core/constants.hpp>
 #include <corundum/core/renderer.hpp>
+#include <corundum/core/bindless.hpp>
 #include <corundum/core/dispatch.hpp>
 #include <corundum/core/pipeline.hpp>
 #include <corundum/core/context.hpp>
@@ -39,7 +41,11 @@
 
 #include <spdlog/spdlog.h>
 
+#include <ftl/task_scheduler.h>
+
 #include <filesystem>
+#include <algorithm>
+#include <future>
 #include <random>
 #include <vector>
 #include <array>
@@ -190,11 +196,11 @@ static inline float random(float min, float max) {
     return std::uniform_real_distribution<float>(min, max)(engine);
 }
 
-static inline Scene build_scene(std::span<Draw> draws, VkDescriptorImageInfo fallback) noexcept {
+// Gathers every ready submesh and its transforms, `texture_index` maps each of its textures (possibly null) to
+// the index the shaders sample.
+template <typename F>
+static inline void fill_scene(Scene& scene, std::span<Draw> draws, F&& texture_index) noexcept {
     crd_profile_scoped();
-    Scene scene;
-    scene.descriptors = { fallback };
-    std::unordered_map<void*, std::uint32_t> cache;
     std::size_t t_size = 0;
     for (const auto& [_, transforms] : draws) {
         t_size += transforms.size();
@@ -205,30 +211,18 @@ static inline Scene build_scene(std::span<Draw> draws, VkDescriptorImageInfo fal
         crd_likely_if(model->is_ready()) {
             const auto submeshes_size = (*model)->submeshes.size();
             auto& handle = scene.models.emplace_back();
-            scene.descriptors.reserve(scene.descriptors.size() + submeshes_size * 3);
-            cache.reserve(cache.size() + submeshes_size * 3 + transforms.size());
             handle.handle = model;
             handle.transform = offset;
             handle.instances = transforms.size();
             handle.submeshes.reserve(submeshes_size);
             for (std::uint32_t j = 0; auto& submesh : (*model)->submeshes) {
                 crd_likely_if(submesh.mesh.is_ready()) {
-                    std::array<std::uint32_t, 3> indices = {};
-                    const auto emplace_descriptor = [&](crd::Async<crd::StaticTexture>* texture, std::uint32_t which) {
-                        crd_likely_if(texture) {
-                            auto& cached = cache[texture];
-                            crd_unlikely_if(cached == 0 && texture->is_ready()) {
-                                scene.descriptors.emplace_back((*texture)->info());
-                                cached = scene.descriptors.size() - 1;
-                            }
-                            indices[which] = cached;
-                        }
-                    };
-                    emplace_descriptor(submesh.diffuse, 0);
-                    emplace_descriptor(submesh.normal, 1);
-                    emplace_descriptor(submesh.specular, 2);
                     handle.submeshes.push_back({
-                        .textures = indices,
+                        .textures = {
+                            texture_index(submesh.diffuse),
+                            texture_index(submesh.normal),
+                            texture_index(submesh.specular)
+                        },
                         .index = j
                     });
                 }
@@ -247,9 +241,68 @@ static inline Scene build_scene(std::span<Draw> draws, VkDescriptorImageInfo fal
         offset += transforms.size();
         i++;
     }
+}
+
+// Rebuilds the texture array every frame, material indices point into scene.descriptors.
+static inline Scene build_scene(std::span<Draw> draws, VkDescriptorImageInfo fallback) noexcept {
+    crd_profile_scoped();
+    Scene scene;
+    scene.descriptors = { fallback };
+    std::unordered_map<void*, std::uint32_t> cache;
+    fill_scene(scene, draws, [&](crd::Async<crd::StaticTexture>* texture) -> std::uint32_t {
+        crd_likely_if(texture) {
+            auto& cached = cache[texture];
+            crd_unlikely_if(cached == 0 && texture->is_ready()) {
+                scene.descriptors.emplace_back((*texture)->info());
+                cached = scene.descriptors.size() - 1;
+            }
+            return cached;
+        }
+        return 0;
+    });
     return scene;
 }
 
+// Material indices are the textures' persistent slots in the renderer's bindless table, scene.descriptors stays empty.
+static inline Scene build_bindless_scene(std::span<Draw> draws, std::uint32_t fallback) noexcept {
+    crd_profile_scoped();
+    Scene scene;
+    fill_scene(scene, draws, [&](crd::Async<crd::StaticTexture>* texture) -> std::uint32_t {
+        crd_likely_if(texture && texture->is_ready()) {
+            const auto slot = (*texture)->bindless_slot();
+            return slot == crd::bindless_null_slot ? fallback : slot;
+        }
+        return fallback;
+    });
+    return scene;
+}
+
+static inline bool is_loaded(std::span<Draw> draws) noexcept {
+    crd_profile_scoped();
+    return std::all_of(draws.begin(), draws.end(), [](const Draw& draw) {
+        return draw.model->is_ready() && std::all_of((*draw.model)->submeshes.begin(), (*draw.model)->submeshes.end(), [](auto& submesh) {
+            return submesh.mesh.is_ready();
+        });
+    });
+}
+
+// Runs GeometryArena::defragment on a fiber and blocks until it is done, call it between frames.
+static inline void defragment_geometry(crd::Context& context) noexcept {
+    crd_profile_scoped();
+    std::promise<void> done;
+    auto future = done.get_future();
+    std::pair<crd::Context*, std::promise<void>*> job = { &context, &done };
+    context.scheduler->AddTask({
+        .Function = +[](ftl::TaskScheduler*, void* data) {
+            auto [context, done] = *static_cast<std::pair<crd::Context*, std::promise<void>*>*>(data);
+            context->geometry->defragment(*context);
+            done->set_value();
+        },
+        .ArgData = &job
+    }, ftl::TaskPriority::Normal);
+    future.wait();
+}
+
 static inline std::array<Cascade, shadow_cascades> calculate_cascades(const Camera& camera, glm::vec3 light_pos) noexcept {
     crd_profile_scoped();
     std::array<Cascade, shadow_cascades> cascades;
@@ -461,7 +461,7 @@ int main() {
             1.0f);
         const auto cascades = calculate_cascades(camera, dir_lights[0].direction);
 
-        crd::wait_fence(context, done);
+        crd::wait_ticket(context, *context.graphics, done);
 
         CameraUniform camera_data;
         camera_data.projection = camera.projection;
@@ -511,8 +511,7 @@ int main() {
                 };
                 commands
                     .push_constants(VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, indices, sizeof indices)
-                    .bind_static_mesh(*raw_submesh.mesh)
-                    .draw_indexed(raw_submesh.indices, model.instances, 0, 0, 0);
+                    .draw_static_mesh(*raw_submesh.mesh, model.instances);
             }
         }
         commands
@@ -534,8 +533,7 @@ int main() {
                 };
                 commands
                     .push_constants(VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, indices, sizeof indices)
-                    .bind_static_mesh(*raw_submesh.mesh)
-                    .draw_indexed(raw_submesh.indices, model.instances, 0, 0, 0);
+                    .draw_static_mesh(*raw_submesh.mesh, model.instances);
             }
         }
         auto& light_cube = models[0]->submeshes[0];
@@ -79,7 +79,8 @@ static inline crd::GraphicsPipeline::CreateInfo shadow_pipeline_info(const crd::
         .depth = {
             .test = true,
             .write = true
-        }
+        },
+        .bindless_set = 1
     };
 }
 
@@ -143,7 +144,8 @@ static inline crd::GraphicsPipeline::CreateInfo final_pipeline_info(const crd::R
         .depth = {
             .test = true,
             .write = false
-        }
+        },
+        .bindless_set = 2
     };
 }
 
@@ -151,6 +153,7 @@ int main() {
     auto window = crd::make_window(1280, 720, "Test FWDP");
     auto context = crd::make_context();
     auto renderer = crd::make_renderer(context);
+    crd_assert(renderer.bindless, "materials are sampled through the bindless table");
     auto swapchain = crd::make_swapchain(context, window);
     auto depth_pass = crd::make_render_pass(context, {
         .attachments = { {
@@ -478,13 +481,13 @@ int main() {
         fps += delta_time;
         ++frames;
         camera.update(window, delta_time);
-        const auto scene = build_scene(draw_cmds, black->info());
+        const auto scene = build_bindless_scene(draw_cmds, black->bindless_slot());
         CameraUniform camera_data;
         camera_data.projection = camera.projection;
         camera_data.view = camera.view;
         camera_data.position = camera.position;
 
-        crd::wait_fence(context, done);
+        crd::wait_ticket(context, *context.graphics, done);
 
         sun_dlight.direction = glm::vec4(
             50.0f * std::cos(crd::current_time() / 6),
@@ -509,8 +512,7 @@ int main() {
             .bind(depth_pipeline.bindings["Models"], model_buffer[index].info());
         shadow_set[index]
             .bind(shadow_pipeline.bindings["Models"], model_buffer[index].info())
-            .bind(shadow_pipeline.bindings["Cascades"], cascades_buffer[index].info())
-            .bind(shadow_pipeline.bindings["textures"], scene.descriptors);
+            .bind(shadow_pipeline.bindings["Cascades"], cascades_buffer[index].info());
         cmp_cull_set[index]
             .bind(cull_pipeline.bindings["CameraBuffer"], camera_buffer[index].info())
             .bind(cull_pipeline.bindings["PointLights"], point_lights_buffer[index].info())
@@ -523,8 +525,7 @@ int main() {
             })));
         main_set[index]
             .bind(final_pipeline.bindings["Uniforms"], camera_buffer[index].info())
-            .bind(final_pipeline.bindings["Models"], model_buffer[index].info())
-            .bind(final_pipeline.bindings["textures"], scene.descriptors);
+            .bind(final_pipeline.bindings["Models"], model_buffer[index].info());
         light_data_set[index]
             .bind(final_pipeline.bindings["PointLights"], point_lights_buffer[index].info())
             .bind(final_pipeline.bindings["DirectionalLights"], directional_lights_buffer[index].info())
@@ -556,8 +557,7 @@ int main() {
                 };
                 commands
                     .push_constants(VK_SHADER_STAGE_VERTEX_BIT, indices, sizeof indices)
-                    .bind_static_mesh(*raw_submesh.mesh)
-                    .draw_indexed(raw_submesh.indices, model.instances, 0, 0, 0);
+                    .draw_static_mesh(*raw_submesh.mesh, model.instances);
             }
         }
         commands
@@ -565,6 +565,7 @@ int main() {
             .begin_render_pass(shadow_pass, 0)
             .bind_pipeline(shadow_pipeline)
             .bind_descriptor_set(0, shadow_set[index])
+            .bind_descriptor_set(1, *renderer.bindless)
             .set_viewport(crd::inverted_viewport)
             .set_scissor();
         for (const auto& model : scene.models) {
@@ -577,8 +578,7 @@ int main() {
                 };
                 commands
                     .push_constants(VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, indices, sizeof indices)
-                    .bind_static_mesh(*raw_submesh.mesh)
-                    .draw_indexed(raw_submesh.indices, model.instances, 0, 0, 0);
+                    .draw_static_mesh(*raw_submesh.mesh, model.instances);
             }
         }
         LightCullPC cull_constants;
@@ -603,7 +603,8 @@ int main() {
             .set_viewport()
             .set_scissor()
             .bind_descriptor_set(0, main_set[index])
-            .bind_descriptor_set(1, light_data_set[index]);
+            .bind_descriptor_set(1, light_data_set[index])
+            .bind_descriptor_set(2, *renderer.bindless);
         for (const auto& model : scene.models) {
             auto& raw_model = **model.handle;
             for (const auto& submesh : model.submeshes) {
@@ -620,16 +621,14 @@ int main() {
                 };
                 commands
                     .push_constants(VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, indices, sizeof indices)
-                    .bind_static_mesh(*raw_submesh.mesh)
-                    .draw_indexed(raw_submesh.indices, model.instances, 0, 0, 0);
+                    .draw_static_mesh(*raw_submesh.mesh, model.instances);
             }
         }
         //auto& cube_mesh = models[0]->submeshes[0];
         commands
             //.bind_pipeline(light_pipeline)
             //.bind_descriptor_set(0, light_view_set[index])
-            //.bind_static_mesh(*cube_mesh.mesh)
-            //.draw_indexed(cube_mesh.indices, p_lights, 0, 0, 0)
+            //.draw_static_mesh(*cube_mesh.mesh, p_lights)
             .end_render_pass()
             .transition_layout({
                 .image = &image,
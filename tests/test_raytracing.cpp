@@ -76,8 +76,8 @@ static inline void make_scene(const crd::Context& context, VkDescriptorImageInfo
                             emplace_descriptor(submesh.diffuse),
                             emplace_descriptor(submesh.normal),
                             emplace_descriptor(submesh.specular),
-                            crd::device_address(context, submesh.mesh->geometry),
-                            crd::device_address(context, submesh.mesh->indices),
+                            crd::device_address(context, *submesh.mesh->geometry),
+                            crd::device_address(context, *submesh.mesh->indices),
                         });
                     }
                 }
@@ -310,7 +310,7 @@ int main() {
         camera_data.projection = glm::inverse(camera.projection);
         camera_data.view = glm::inverse(camera.view);
 
-        crd::wait_fence(context, done);
+        crd::wait_ticket(context, *context.graphics, done);
 
         camera_buffer.write(&camera_data, sizeof camera_data);
 
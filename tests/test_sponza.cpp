@@ -325,7 +325,13 @@ int main() {
     auto light_data_set = crd::make_descriptor_set(context, combine_pipeline.layout.sets[1]);
     std::size_t frames = 0;
     double delta_time = 0, last_frame = 0, fps = 0;
+    bool defragmented = false;
     while (!window.is_closed()) {
+        // Loaders scatter meshes across geometry blocks as they finish, repack them once everything arrived.
+        if (!defragmented && is_loaded(draw_cmds)) {
+            defragment_geometry(context);
+            defragmented = true;
+        }
         auto [commands, image, index, wait, signal, done] = crd::acquire_frame(context, renderer, window, swapchain);
         const auto scene = build_scene(draw_cmds, black->info());
         const auto current_frame = crd::current_time();
@@ -339,7 +345,7 @@ int main() {
             fps = 0;
         }
 
-        crd::wait_fence(context, done);
+        crd::wait_ticket(context, *context.graphics, done);
 
         model_buffer[index].write(scene.transforms.data(), crd::size_bytes(scene.transforms));
         light_model_buffer[index].write(light_ts.data(), crd::size_bytes(light_ts));
@@ -385,8 +391,7 @@ int main() {
                 };
                 commands
                     .push_constants(VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, indices, sizeof(indices))
-                    .bind_static_mesh(*raw_submesh.mesh)
-                    .draw_indexed(raw_submesh.indices, model.instances, 0, 0, 0);
+                    .draw_static_mesh(*raw_submesh.mesh, model.instances);
             }
         }
         auto& light_cube = models[0]->submeshes[0];
@@ -398,8 +403,7 @@ int main() {
             .draw(3, 1, 0, 0)
             .bind_pipeline(light_pipeline)
             .bind_descriptor_set(0, light_set[index])
-            .bind_static_mesh(*light_cube.mesh)
-            .draw_indexed(light_cube.indices, nlights, 0, 0, 0)
+            .draw_static_mesh(*light_cube.mesh, nlights)
             .end_render_pass()
             .transition_layout({
                 .image = &image,
@@ -0,0 +1,180 @@
+#include <corundum/core/static_model.hpp>
+
+#include <corundum/detail/texture_codec.hpp>
+#include <corundum/detail/archive.hpp>
+
+#include <spdlog/spdlog.h>
+
+#include <stb_image.h>
+
+#include <string_view>
+#include <filesystem>
+#include <fstream>
+#include <cstring>
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static void print_usage() noexcept {
+    spdlog::info("usage: crd-cook texture <input> [--srgb] [--codec bc1|bc3|bc5|bc7] [--output <path>]");
+    spdlog::info("       crd-cook model <input> [--compact] [--output <path>]");
+    spdlog::info("       crd-cook pack <directory> [--output <path>]");
+}
+
+static bool write_file(const fs::path& path, const std::vector<std::uint8_t>& data) noexcept {
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+    return file.good();
+}
+
+static int cook_texture(int argc, char** argv) noexcept {
+    crd_unlikely_if(argc < 3) {
+        print_usage();
+        return 1;
+    }
+    const fs::path input = argv[2];
+    auto output = fs::path(input).replace_extension(".crdt");
+    auto codec = crd::dtl::texture_codec_bc7;
+    auto srgb = false;
+    for (int i = 3; i < argc; ++i) {
+        const std::string_view option = argv[i];
+        if (option == "--srgb") {
+            srgb = true;
+        } else if (option == "--codec" && i + 1 < argc) {
+            const std::string_view name = argv[++i];
+            if (name == "bc1") {
+                codec = crd::dtl::texture_codec_bc1;
+            } else if (name == "bc3") {
+                codec = crd::dtl::texture_codec_bc3;
+            } else if (name == "bc5") {
+                codec = crd::dtl::texture_codec_bc5;
+            } else if (name == "bc7") {
+                codec = crd::dtl::texture_codec_bc7;
+            } else {
+                spdlog::error("unknown codec: {}", name);
+                return 1;
+            }
+        } else if (option == "--output" && i + 1 < argc) {
+            output = argv[++i];
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+    const auto start = std::chrono::steady_clock::now();
+    std::int32_t width, height, channels;
+    auto pixels = stbi_load(input.generic_string().c_str(), &width, &height, &channels, STBI_rgb_alpha);
+    crd_unlikely_if(!pixels) {
+        spdlog::error("failed to load \"{}\": {}", input.generic_string(), stbi_failure_reason());
+        return 1;
+    }
+    const auto cooked = crd::dtl::cook_texture(pixels, width, height, srgb, codec);
+    stbi_image_free(pixels);
+    crd_unlikely_if(!write_file(output, cooked)) {
+        spdlog::error("failed to write \"{}\"", output.generic_string());
+        return 1;
+    }
+    const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    spdlog::info("cooked \"{}\" -> \"{}\", {}x{}, {} -> {} bytes in {:.1f} ms",
+                 input.generic_string(), output.generic_string(), width, height,
+                 (std::size_t)width * height * 4, cooked.size(), elapsed);
+    return 0;
+}
+
+static int cook_model(int argc, char** argv) noexcept {
+    crd_unlikely_if(argc < 3) {
+        print_usage();
+        return 1;
+    }
+    const fs::path input = argv[2];
+    auto output = fs::path(input).replace_extension(".crdm");
+    auto format = crd::vertex_format_float;
+    for (int i = 3; i < argc; ++i) {
+        const std::string_view option = argv[i];
+        if (option == "--compact") {
+            format = crd::vertex_format_compact;
+        } else if (option == "--output" && i + 1 < argc) {
+            output = argv[++i];
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+    const auto start = std::chrono::steady_clock::now();
+    const auto cooked = crd::cook_static_model(input.generic_string(), format);
+    crd_unlikely_if(cooked.empty()) {
+        return 1;
+    }
+    crd_unlikely_if(!write_file(output, cooked)) {
+        spdlog::error("failed to write \"{}\"", output.generic_string());
+        return 1;
+    }
+    const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    spdlog::info("cooked \"{}\" -> \"{}\", {} bytes in {:.1f} ms",
+                 input.generic_string(), output.generic_string(), cooked.size(), elapsed);
+    return 0;
+}
+
+static int cook_pack(int argc, char** argv) noexcept {
+    crd_unlikely_if(argc < 3) {
+        print_usage();
+        return 1;
+    }
+    const fs::path input = argv[2];
+    auto output = fs::path(input).lexically_normal();
+    output = output.has_filename() ? output : output.parent_path();
+    output += ".crdp";
+    for (int i = 3; i < argc; ++i) {
+        const std::string_view option = argv[i];
+        if (option == "--output" && i + 1 < argc) {
+            output = argv[++i];
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::string> paths;
+    std::vector<std::vector<std::uint8_t>> contents;
+    std::size_t total = 0;
+    for (const auto& entry : fs::recursive_directory_iterator(input)) {
+        crd_unlikely_if(!entry.is_regular_file()) {
+            continue;
+        }
+        std::ifstream file(entry.path(), std::ios::binary);
+        auto& content = contents.emplace_back(entry.file_size());
+        file.read(reinterpret_cast<char*>(content.data()), content.size());
+        paths.emplace_back(entry.path().lexically_relative(input).generic_string());
+        total += content.size();
+    }
+    const auto packed = crd::dtl::pack_archive(paths, contents);
+    crd_unlikely_if(!write_file(output, packed)) {
+        spdlog::error("failed to write \"{}\"", output.generic_string());
+        return 1;
+    }
+    const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    spdlog::info("packed \"{}\" -> \"{}\", {} files, {} -> {} bytes in {:.1f} ms",
+                 input.generic_string(), output.generic_string(), paths.size(), total, packed.size(), elapsed);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    crd_unlikely_if(argc < 2) {
+        print_usage();
+        return 1;
+    }
+    const std::string_view command = argv[1];
+    if (command == "texture") {
+        return cook_texture(argc, argv);
+    }
+    if (command == "model") {
+        return cook_model(argc, argv);
+    }
+    if (command == "pack") {
+        return cook_pack(argc, argv);
+    }
+    print_usage();
+    return 1;
+}